@@ -0,0 +1,175 @@
+/**
+ * @file bench_accel.cpp
+ * @brief Benchmark for AccelCurve and AccelDesigner
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <benchmark/benchmark.h>
+#include <ctrl/accel_designer.h>
+#include <ctrl/straight/trajectory.h>
+
+#include <array>
+#include <random>
+#include <vector>
+
+using namespace ctrl;
+
+/* the 12 branch cases of examples/accel */
+static constexpr std::array<std::array<float, 6>, 12> kDesignerCases = {{
+    {100, 10, 4, 0, 2, 4},      //< vs -> vm -> vt, tm1>0, tm2>0
+    {100, 10, 4, 0, 3, 4},      //< vs -> vm -> vt, tm1>0, tm2<0
+    {100, 10, 4, 3, 0, 4},      //< vs -> vm -> vt, tm1<0, tm2>0
+    {100, 10, 8, 0, 2, 4},      //< vs -> vr -> vt, vr<vm, tm1>0, tm2>0
+    {100, 10, 8, 0, 6, 4},      //< vs -> vr -> vt, vr<vm, tm1>0, tm2<0
+    {100, 10, 8, 0, 0.5, 0.2},  //< vs -> vr -> vt, vr<vm, tm1<0, tm2<0
+    {100, 10, 6, 0, 3, 1},      //< vs -> vr -> vt, vr<vm, tm1>0, tm2<0
+    {100, 10, 6, 0, 4, 1},      //< ve == vt, tm > 0 just
+    {100, 10, 8, 0, 6, 1},      //< ve != vt, tm > 0, accel
+    {100, 10, 8, 4, 0, 1},      //< ve != vt, tm > 0, decel
+    {100, 10, 4, 0, 4, 0.1},    //< ve != vt, tm < 0, accel
+    {100, 10, 4, 4, 0, 0.1},    //< ve != vt, tm < 0, decel
+}};
+
+static void AccelCurve_Reset(benchmark::State& state) {
+  AccelCurve ac;
+  /* tm > 0 and tm < 0 */
+  const float v_end = state.range(0) ? 4 : 0.5f;
+  for (auto _ : state) {
+    ac.reset(100, 10, 0, v_end);
+    benchmark::DoNotOptimize(ac);
+  }
+}
+BENCHMARK(AccelCurve_Reset)->Arg(0)->Arg(1);
+
+static void AccelCurve_Eval(benchmark::State& state) {
+  const AccelCurve ac(100, 10, 0, 4);
+  const float dt = ac.t_end() / 64;
+  float t = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ac.j(t));
+    benchmark::DoNotOptimize(ac.a(t));
+    benchmark::DoNotOptimize(ac.v(t));
+    benchmark::DoNotOptimize(ac.x(t));
+    t = t > ac.t_end() ? 0 : t + dt;
+  }
+}
+BENCHMARK(AccelCurve_Eval);
+
+static void AccelDesigner_Reset(benchmark::State& state) {
+  const auto& p = kDesignerCases[state.range(0)];
+  AccelDesigner ad;
+  for (auto _ : state) {
+    ad.reset(p[0], p[1], p[2], p[3], p[4], p[5]);
+    benchmark::DoNotOptimize(ad);
+  }
+}
+BENCHMARK(AccelDesigner_Reset)->DenseRange(0, kDesignerCases.size() - 1);
+
+/* the limits shared by all of kDesignerCases */
+struct DesignerLimits {
+  static constexpr float j_max = 100;
+  static constexpr float a_max = 10;
+};
+
+static void AccelDesignerFixed_Reset(benchmark::State& state) {
+  const auto& p = kDesignerCases[state.range(0)];
+  AccelDesignerFixed<DesignerLimits> ad;
+  for (auto _ : state) {
+    ad.reset(p[2], p[3], p[4], p[5]);
+    benchmark::DoNotOptimize(ad);
+  }
+}
+BENCHMARK(AccelDesignerFixed_Reset)
+    ->DenseRange(0, kDesignerCases.size() - 1);
+
+static void AccelDesigner_Restore(benchmark::State& state) {
+  const auto& p = kDesignerCases[state.range(0)];
+  const auto profile =
+      AccelDesigner(p[0], p[1], p[2], p[3], p[4], p[5]).profile();
+  AccelDesigner ad;
+  for (auto _ : state) {
+    ad.reset(p[0], p[1], profile);
+    benchmark::DoNotOptimize(ad);
+  }
+}
+BENCHMARK(AccelDesigner_Restore)->DenseRange(0, kDesignerCases.size() - 1);
+
+static void AccelDesigner_Eval(benchmark::State& state) {
+  const auto& p = kDesignerCases[0];
+  const AccelDesigner ad(p[0], p[1], p[2], p[3], p[4], p[5]);
+  const float dt = ad.t_end() / 64;
+  float t = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ad.j(t));
+    benchmark::DoNotOptimize(ad.a(t));
+    benchmark::DoNotOptimize(ad.v(t));
+    benchmark::DoNotOptimize(ad.x(t));
+    t = t > ad.t_end() ? 0 : t + dt;
+  }
+}
+BENCHMARK(AccelDesigner_Eval);
+
+static void AccelDesigner_Walker(benchmark::State& state) {
+  const auto& p = kDesignerCases[0];
+  const AccelDesigner ad(p[0], p[1], p[2], p[3], p[4], p[5]);
+  const float dt = ad.t_end() / 64;
+  AccelDesigner::Walker w(ad);
+  float t = 0;
+  for (auto _ : state) {
+    const auto e = w.at(t);
+    benchmark::DoNotOptimize(e);
+    if (t > ad.t_end()) t = 0, w = AccelDesigner::Walker(ad);
+    t += dt;
+  }
+}
+BENCHMARK(AccelDesigner_Walker);
+
+template <bool kRollout>
+static void StraightTrajectory_Rollout(benchmark::State& state) {
+  straight::Trajectory tr;
+  tr.reset(240000, 9000, 2400, 0, 0, 1800);
+  const float Ts = 1e-3f;
+  const auto n = static_cast<std::size_t>(tr.t_end() / Ts) + 1;
+  std::vector<State> out(n);
+  for (auto _ : state) {
+    if (kRollout) {
+      tr.rollout(Ts, out.data(), n);
+    } else {
+      for (std::size_t i = 0; i < n; ++i) tr.update(out[i], i * Ts);
+    }
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(StraightTrajectory_Rollout, false);
+BENCHMARK_TEMPLATE(StraightTrajectory_Rollout, true);
+
+/* random times over all segments to provoke branch mispredictions */
+template <bool kBranchless>
+static void AccelDesigner_EvalRandom(benchmark::State& state) {
+  const auto& p = kDesignerCases[0];
+  const AccelDesigner ad(p[0], p[1], p[2], p[3], p[4], p[5]);
+  std::mt19937 mt(0);
+  std::uniform_real_distribution<float> urd(-0.1f, ad.t_end() + 0.1f);
+  std::array<float, 1024> ts;
+  for (auto& t : ts) t = urd(mt);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const float t = ts[i++ % ts.size()];
+    if (kBranchless) {
+      benchmark::DoNotOptimize(ad.jBranchless(t));
+      benchmark::DoNotOptimize(ad.aBranchless(t));
+      benchmark::DoNotOptimize(ad.vBranchless(t));
+      benchmark::DoNotOptimize(ad.xBranchless(t));
+    } else {
+      benchmark::DoNotOptimize(ad.j(t));
+      benchmark::DoNotOptimize(ad.a(t));
+      benchmark::DoNotOptimize(ad.v(t));
+      benchmark::DoNotOptimize(ad.x(t));
+    }
+  }
+}
+BENCHMARK_TEMPLATE(AccelDesigner_EvalRandom, false);
+BENCHMARK_TEMPLATE(AccelDesigner_EvalRandom, true);
@@ -0,0 +1,44 @@
+/**
+ * @file bench_control.cpp
+ * @brief Benchmark for TrajectoryTracker and FeedbackController
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <benchmark/benchmark.h>
+#include <ctrl/feedback_controller.h>
+#include <ctrl/straight/trajectory.h>
+#include <ctrl/trajectory_tracker.h>
+
+using namespace ctrl;
+
+static void TrajectoryTracker_Update(benchmark::State& state) {
+  straight::Trajectory tr;
+  tr.reset(240000, 6000, 1200, 0, 600, 360);
+  TrajectoryTracker tt(TrajectoryTracker::Gain{});
+  tt.reset();
+  const float Ts = 1e-3f;
+  State s;
+  float t = 0;
+  for (auto _ : state) {
+    tr.update(s, t);
+    /* slightly off the reference to exercise the feedback terms */
+    const auto est_q = s.q + Pose(1, 1, 0.01f);
+    const auto est_v = Polar(s.dq.x, 0);
+    const auto est_a = Polar(s.ddq.x, 0);
+    benchmark::DoNotOptimize(tt.update(est_q, est_v, est_a, s));
+    t = t > tr.t_end() ? 0 : t + Ts;
+  }
+}
+BENCHMARK(TrajectoryTracker_Update);
+
+static void FeedbackController_Update(benchmark::State& state) {
+  FeedbackController<Polar> fc({Polar(1, 1), Polar(0.1f, 0.1f)},
+                               {Polar(1, 1), Polar(0.1f, 0.1f), Polar(0, 0)});
+  Polar r(1, 1), y(0.9f, 1.1f), dr(0, 0), dy(0, 0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(r);
+    benchmark::DoNotOptimize(fc.update(r, y, dr, dy, 1e-3f));
+  }
+}
+BENCHMARK(FeedbackController_Update);
@@ -0,0 +1,52 @@
+/**
+ * @file bench_library.cpp
+ * @brief Benchmark for LibraryView
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <benchmark/benchmark.h>
+#include <ctrl/library.h>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ctrl;
+
+/* a 10k-entry shape table in a 4-byte aligned buffer */
+static const std::vector<uint32_t>& shapeLibrary(std::size_t* size) {
+  static std::string bytes;
+  static std::vector<uint32_t> buf;
+  if (buf.empty()) {
+    const std::vector<slalom::Shape> shapes(
+        10000, slalom::Shape(Pose(45, 45, M_PI / 2), 44));
+    std::stringstream ss;
+    writeLibrary(ss, shapes.data(), shapes.size());
+    bytes = ss.str();
+    buf.resize((bytes.size() + 3) / 4);
+    std::memcpy(buf.data(), bytes.data(), bytes.size());
+  }
+  *size = bytes.size();
+  return buf;
+}
+
+static void Library_Open(benchmark::State& state) {
+  std::size_t size;
+  const auto& buf = shapeLibrary(&size);
+  for (auto _ : state) {
+    const LibraryView<slalom::Shape> view(buf.data(), size);
+    benchmark::DoNotOptimize(view[view.size() - 1].v_ref);
+  }
+}
+BENCHMARK(Library_Open);
+
+static void Library_Verify(benchmark::State& state) {
+  std::size_t size;
+  const auto& buf = shapeLibrary(&size);
+  const LibraryView<slalom::Shape> view(buf.data(), size);
+  for (auto _ : state) benchmark::DoNotOptimize(view.verify());
+  state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(Library_Verify);
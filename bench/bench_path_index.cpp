@@ -0,0 +1,71 @@
+/**
+ * @file bench_path_index.cpp
+ * @brief Benchmark for PathIndex
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <benchmark/benchmark.h>
+#include <ctrl/path_index.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace ctrl;
+
+template <std::size_t N>
+static std::vector<Pose> makeMoves() {
+  std::minstd_rand rng;
+  std::vector<Pose> moves(N);
+  for (auto& m : moves) {
+    const auto th = ((rng() % 3) - 1.0f) * float(M_PI) / 2;
+    m = th == 0 ? Pose(90, 0, 0) : Pose(45, th > 0 ? 45 : -45, th);
+  }
+  return moves;
+}
+
+template <std::size_t N>
+static void PathIndex_PoseAt(benchmark::State& state) {
+  /* built once outside the timed loop; too large for the stack */
+  const auto pi = std::make_unique<PathIndex<N>>();
+  for (const auto& m : makeMoves<N>()) {
+    if (!pi->push(m, 90)) return state.SkipWithError("PathIndex is full");
+  }
+  std::minstd_rand rng;
+  for (auto _ : state) {
+    const auto q = pi->poseAt((rng() % (N * 90)) + 0.5f);
+    benchmark::DoNotOptimize(q);
+  }
+}
+BENCHMARK_TEMPLATE(PathIndex_PoseAt, 64);
+BENCHMARK_TEMPLATE(PathIndex_PoseAt, 1024);
+
+template <std::size_t N>
+static void PathIndex_Recompose(benchmark::State& state) {
+  const auto moves = makeMoves<N>();
+  std::minstd_rand rng;
+  for (auto _ : state) {
+    const auto k = rng() % N;
+    Pose q;
+    for (std::size_t i = 0; i < k; ++i) q = moves[i].homogeneous(q);
+    benchmark::DoNotOptimize(q);
+  }
+}
+BENCHMARK_TEMPLATE(PathIndex_Recompose, 64);
+BENCHMARK_TEMPLATE(PathIndex_Recompose, 1024);
+
+static void PathIndex_Push(benchmark::State& state) {
+  constexpr std::size_t N = 1024;
+  static PathIndex<N> pi;
+  const auto moves = makeMoves<N>();
+  for (auto _ : state) {
+    pi.clear();
+    for (const auto& m : moves) pi.push(m, 90);
+    benchmark::DoNotOptimize(pi.pose(N));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * N);
+}
+BENCHMARK(PathIndex_Push);
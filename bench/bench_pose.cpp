@@ -0,0 +1,100 @@
+/**
+ * @file bench_pose.cpp
+ * @brief Benchmark for Pose odometry and batch transforms
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <benchmark/benchmark.h>
+#include <ctrl/polar.h>
+#include <ctrl/pose.h>
+
+#include <random>
+#include <vector>
+
+using namespace ctrl;
+
+static std::vector<Polar> makeOdometry(const std::size_t n) {
+  std::minstd_rand rng;
+  std::vector<Polar> deltas(n);
+  for (auto& d : deltas) d = {1 + (rng() % 100) * 1e-3f, (rng() % 100) * 1e-4f};
+  return deltas;
+}
+
+static void Pose_OdometryRotate(benchmark::State& state) {
+  const auto deltas = makeOdometry(1024);
+  for (auto _ : state) {
+    Pose q;
+    for (const auto& d : deltas) q = Pose(d.tra, 0, d.rot).homogeneous(q);
+    benchmark::DoNotOptimize(q);
+  }
+  state.SetItemsProcessed(state.iterations() * deltas.size());
+}
+BENCHMARK(Pose_OdometryRotate);
+
+static void Pose_OdometryArc(benchmark::State& state) {
+  const auto deltas = makeOdometry(1024);
+  for (auto _ : state) {
+    Pose q;
+    for (const auto& d : deltas) q = q.arc(d.tra, d.rot);
+    benchmark::DoNotOptimize(q);
+  }
+  state.SetItemsProcessed(state.iterations() * deltas.size());
+}
+BENCHMARK(Pose_OdometryArc);
+
+static void Pose_OdometryIntegrate(benchmark::State& state) {
+  const auto deltas = makeOdometry(1024);
+  std::vector<Pose> trace(deltas.size());
+  for (auto _ : state) {
+    const auto q =
+        Pose::integrate(Pose(), deltas.data(), deltas.size(), trace.data());
+    benchmark::DoNotOptimize(q);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * deltas.size());
+}
+BENCHMARK(Pose_OdometryIntegrate);
+
+static void Pose_TransformPointsLoop(benchmark::State& state) {
+  const std::size_t n = 256;
+  std::vector<Pose> in(n), out(n);
+  for (std::size_t i = 0; i < n; ++i) in[i] = {i * 0.5f, 90 - i * 0.25f};
+  Pose offset(45, 90, 0.3f);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < n; ++i) out[i] = in[i].homogeneous(offset);
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(Pose_TransformPointsLoop);
+
+static void Pose_TransformPointsBatch(benchmark::State& state) {
+  const std::size_t n = 256;
+  std::vector<float> x(n), y(n), out_x(n), out_y(n);
+  for (std::size_t i = 0; i < n; ++i) x[i] = i * 0.5f, y[i] = 90 - i * 0.25f;
+  Pose offset(45, 90, 0.3f);
+  for (auto _ : state) {
+    Pose::transformPoints(offset, x.data(), y.data(), out_x.data(),
+                          out_y.data(), n);
+    benchmark::DoNotOptimize(out_x.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(Pose_TransformPointsBatch);
+
+static void Pose_TransformPosesBatch(benchmark::State& state) {
+  const std::size_t n = 256;
+  std::vector<Pose> in(n), out(n);
+  for (std::size_t i = 0; i < n; ++i) in[i] = {i * 0.5f, 90 - i * 0.25f};
+  Pose offset(45, 90, 0.3f);
+  for (auto _ : state) {
+    Pose::transform(offset, in.data(), out.data(), n);
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(Pose_TransformPosesBatch);
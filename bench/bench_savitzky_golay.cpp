@@ -0,0 +1,42 @@
+/**
+ * @file bench_savitzky_golay.cpp
+ * @brief Benchmark for SavitzkyGolay
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <benchmark/benchmark.h>
+#include <ctrl/accumulator.h>
+#include <ctrl/savitzky_golay.h>
+
+using namespace ctrl;
+
+template <std::size_t S>
+static void SavitzkyGolay_Update(benchmark::State& state) {
+  SavitzkyGolay<S, 2> sg(1e-3f);
+  float value = 0;
+  for (auto _ : state) {
+    sg.push(value += 1);
+    benchmark::DoNotOptimize(sg.d1());
+    benchmark::DoNotOptimize(sg.d2());
+  }
+}
+BENCHMARK_TEMPLATE(SavitzkyGolay_Update, 8);
+BENCHMARK_TEMPLATE(SavitzkyGolay_Update, 32);
+BENCHMARK_TEMPLATE(SavitzkyGolay_Update, 128);
+
+template <std::size_t S>
+static void SavitzkyGolay_Accumulator(benchmark::State& state) {
+  using SG = SavitzkyGolay<S, 2>;
+  static constexpr auto kCoeff2 = savitzkyGolayCoefficients<S, 2, 2>();
+  Accumulator<float, S> acc;
+  float value = 0;
+  for (auto _ : state) {
+    acc.push(value += 1);
+    benchmark::DoNotOptimize(SG::apply(SG::kCoeff1, acc));
+    benchmark::DoNotOptimize(SG::apply(kCoeff2, acc));
+  }
+}
+BENCHMARK_TEMPLATE(SavitzkyGolay_Accumulator, 8);
+BENCHMARK_TEMPLATE(SavitzkyGolay_Accumulator, 32);
+BENCHMARK_TEMPLATE(SavitzkyGolay_Accumulator, 128);
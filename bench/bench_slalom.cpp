@@ -0,0 +1,76 @@
+/**
+ * @file bench_slalom.cpp
+ * @brief Benchmark for slalom::Shape and slalom::Trajectory
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <benchmark/benchmark.h>
+#include <ctrl/slalom/trajectory.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ctrl;
+
+static void Shape_Construct(benchmark::State& state) {
+  const float PI = M_PI;
+  for (auto _ : state) {
+    const auto ss = slalom::Shape(Pose(45, 45, PI / 2), 40);
+    benchmark::DoNotOptimize(ss);
+  }
+}
+BENCHMARK(Shape_Construct);
+
+static void Shape_Integrate(benchmark::State& state) {
+  const auto ss = slalom::Shape(Pose(45, 45, M_PI / 2), 40);
+  const AccelDesigner ad(ss.dddth_max, ss.ddth_max, ss.dth_max, 0, 0,
+                         ss.total.th);
+  const float Ts = 1e-3f;
+  State s;
+  float t = 0;
+  for (auto _ : state) {
+    slalom::Shape::integrate(ad, s, ss.v_ref, t, Ts);
+    benchmark::DoNotOptimize(s);
+    t = t > ad.t_end() ? 0 : t + Ts;
+  }
+}
+BENCHMARK(Shape_Integrate);
+
+static void Trajectory_Rollout(benchmark::State& state) {
+  const auto ss = slalom::Shape(Pose(45, 45, M_PI / 2), 40);
+  slalom::Trajectory st(ss);
+  st.reset(ss.v_ref);
+  const float Ts = 1e-3f;
+  const auto n = static_cast<std::size_t>(st.getTimeCurve() / Ts);
+  std::vector<State> out(n);
+  for (auto _ : state) {
+    st.rollout(Ts, out.data(), n);
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(Trajectory_Rollout);
+
+static void Trajectory_UpdateLoop(benchmark::State& state) {
+  const auto ss = slalom::Shape(Pose(45, 45, M_PI / 2), 40);
+  slalom::Trajectory st(ss);
+  st.reset(ss.v_ref);
+  const float Ts = 1e-3f;
+  const auto n = static_cast<std::size_t>(st.getTimeCurve() / Ts);
+  std::vector<State> out(n);
+  for (auto _ : state) {
+    State s;
+    st.update(s, 0, 0);
+    out[0] = s;
+    for (std::size_t i = 1; i < n; ++i) {
+      st.update(s, (i - 1) * Ts, Ts);
+      out[i] = s;
+    }
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(Trajectory_UpdateLoop);
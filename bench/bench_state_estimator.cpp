@@ -0,0 +1,49 @@
+/**
+ * @file bench_state_estimator.cpp
+ * @brief Benchmark for StateEstimator
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <benchmark/benchmark.h>
+#include <ctrl/state_estimator.h>
+#include <ctrl/straight/trajectory.h>
+#include <ctrl/trajectory_tracker.h>
+
+using namespace ctrl;
+
+static void StateEstimator_Tick(benchmark::State& state) {
+  StateEstimator se;
+  const float Ts = 1e-3f;
+  float v = 0;
+  for (auto _ : state) {
+    se.predict(Ts);
+    se.updateEncoder(v += 1e-3f);
+    se.updateGyro(1);
+    benchmark::DoNotOptimize(se.state());
+  }
+}
+BENCHMARK(StateEstimator_Tick);
+
+static void StateEstimator_TickWithTracker(benchmark::State& state) {
+  straight::Trajectory tr;
+  tr.reset(240000, 6000, 1200, 0, 600, 360);
+  TrajectoryTracker tt(TrajectoryTracker::Gain{});
+  tt.reset();
+  StateEstimator se;
+  const float Ts = 1e-3f;
+  State s;
+  float t = 0;
+  int tick = 0;
+  for (auto _ : state) {
+    tr.update(s, t);
+    se.predict(Ts);
+    se.updateEncoder(s.dq.x);
+    se.updateGyro(s.dq.th);
+    /* wall-sensor pose correction every 100 ticks */
+    if (++tick % 100 == 0) se.updatePose(s.q);
+    benchmark::DoNotOptimize(tt.update(se.q(), se.v(), se.a(), s));
+    t = t > tr.t_end() ? 0 : t + Ts;
+  }
+}
+BENCHMARK(StateEstimator_TickWithTracker);
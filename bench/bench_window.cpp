@@ -0,0 +1,73 @@
+/**
+ * @file bench_window.cpp
+ * @brief Benchmark for Accumulator and window statistics
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <benchmark/benchmark.h>
+#include <ctrl/accumulator.h>
+#include <ctrl/window_statistics.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+using namespace ctrl;
+
+template <std::size_t S>
+static void Accumulator_Average(benchmark::State& state) {
+  Accumulator<float, S> acc;
+  float value = 0;
+  for (auto _ : state) {
+    acc.push(value += 1);
+    benchmark::DoNotOptimize(acc.average());
+  }
+}
+BENCHMARK_TEMPLATE(Accumulator_Average, 8);
+BENCHMARK_TEMPLATE(Accumulator_Average, 64);
+BENCHMARK_TEMPLATE(Accumulator_Average, 1024);
+
+template <std::size_t S>
+static void WindowStatistics_Incremental(benchmark::State& state) {
+  WindowVariance<float, S> wv;
+  WindowMinMax<float, S> wm;
+  WindowMedian<float, S> wd;
+  std::minstd_rand rng;
+  for (auto _ : state) {
+    const float value = rng() % 1000;
+    wv.push(value), wm.push(value), wd.push(value);
+    benchmark::DoNotOptimize(wv.variance());
+    benchmark::DoNotOptimize(wm.min());
+    benchmark::DoNotOptimize(wm.max());
+    benchmark::DoNotOptimize(wd.median());
+  }
+}
+BENCHMARK_TEMPLATE(WindowStatistics_Incremental, 8);
+BENCHMARK_TEMPLATE(WindowStatistics_Incremental, 64);
+BENCHMARK_TEMPLATE(WindowStatistics_Incremental, 1024);
+
+template <std::size_t S>
+static void WindowStatistics_Naive(benchmark::State& state) {
+  Accumulator<float, S> acc;
+  std::array<float, S> work;
+  std::minstd_rand rng;
+  for (auto _ : state) {
+    acc.push(rng() % 1000);
+    const auto mean = acc.average();
+    float var = 0;
+    for (std::size_t i = 0; i < S; ++i) {
+      work[i] = acc[i];
+      var += (acc[i] - mean) * (acc[i] - mean);
+    }
+    benchmark::DoNotOptimize(var / S);
+    const auto mm = std::minmax_element(work.begin(), work.end());
+    benchmark::DoNotOptimize(*mm.first);
+    benchmark::DoNotOptimize(*mm.second);
+    std::nth_element(work.begin(), work.begin() + S / 2, work.end());
+    benchmark::DoNotOptimize(work[S / 2]);
+  }
+}
+BENCHMARK_TEMPLATE(WindowStatistics_Naive, 8);
+BENCHMARK_TEMPLATE(WindowStatistics_Naive, 64);
+BENCHMARK_TEMPLATE(WindowStatistics_Naive, 1024);
@@ -0,0 +1,310 @@
+/**
+ * @file main.cpp
+ * @brief worst-case execution time analysis of AccelDesigner::reset
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ *
+ * Enumerates and fuzzes constraint inputs, classifies each input by the path
+ * taken through AccelDesigner::reset, and reports per-path histograms of the
+ * execution time with the 99.9th percentile and maximum. The time of each
+ * input is the maximum over the repetitions.
+ *
+ * usage: wcet [n_fuzz] [csv]
+ */
+#define CTRL_LOG_LEVEL CTRL_LOG_LEVEL_NONE
+#include <ctrl/accel_designer.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static const char* const kUnit = "ticks";
+static inline uint64_t now() {
+  _mm_lfence();
+  const uint64_t t = __rdtsc();
+  _mm_lfence();
+  return t;
+}
+#else
+static const char* const kUnit = "ns";
+static inline uint64_t now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+#endif
+
+using namespace ctrl;
+
+/**
+ * @brief constraint input of AccelDesigner::reset
+ */
+struct Input {
+  float jm, am, vm, vs, vt, d;
+};
+
+/**
+ * @brief paths through AccelDesigner::reset
+ * @details bits 0-1: branch of calcReachableVelocityEnd (0: not called),
+ * bit 2: calcReachableVelocityMax is called
+ */
+static const std::array<const char*, 8> kPathNames = {{
+    "vs->vm->vt",
+    "ve: c-s-c (sqrt)",
+    "ve: c-c accel (cbrt)",
+    "ve: c-c decel (hypot, atan2, cbrt, cos)",
+    "vr",
+    "ve: c-s-c (sqrt) + vr",
+    "ve: c-c accel (cbrt) + vr",
+    "ve: c-c decel (hypot, atan2, cbrt, cos) + vr",
+}};
+
+/**
+ * @brief designer that reports the path taken by design()
+ */
+struct PathDesigner : public AccelDesigner {
+  int path(const Input& in) {
+    int p = 0;
+    design(AccelLimits(in.jm, in.am), in.vm, in.vs, in.vt, in.d, 0, 0, &p);
+    return p;
+  }
+};
+
+/**
+ * @brief classify the path as reported by AccelDesigner::design
+ */
+static int classify(const Input& in) {
+  PathDesigner pd;
+  return pd.path(in);
+}
+
+__attribute__((noinline)) static void run(AccelDesigner& ad, const Input& in) {
+  ad.reset(in.jm, in.am, in.vm, in.vs, in.vt, in.d);
+}
+
+__attribute__((noinline)) static void empty(AccelDesigner&, const Input&) {
+  asm volatile("" ::: "memory");
+}
+
+/**
+ * @brief measure the time of f over repetitions
+ * @return the minimum and the maximum over the repetitions
+ */
+template <typename F>
+static std::pair<uint64_t, uint64_t> measure(F f, AccelDesigner& ad,
+                                             const Input& in,
+                                             const int repeat) {
+  uint64_t lo = UINT64_MAX, hi = 0;
+  for (int r = 0; r < repeat; ++r) {
+    const auto ts = now();
+    f(ad, in);
+    const auto te = now();
+    lo = std::min<uint64_t>(lo, te - ts);
+    hi = std::max<uint64_t>(hi, te - ts);
+  }
+  return {lo, hi};
+}
+
+/**
+ * @brief enumerated grid and fuzzed inputs in the same ranges
+ */
+static std::vector<Input> makeInputs(const int n_fuzz) {
+  std::vector<Input> inputs;
+  for (const float jm : {50.0f, 100.0f, 500.0f})
+    for (const float am : {5.0f, 10.0f, 20.0f})
+      for (const float vm : {2.0f, 4.0f, 8.0f})
+        for (int i = 0; i <= 8; ++i)
+          for (int k = 0; k <= 8; ++k)
+            for (int l = 0; l <= 12; ++l)
+              for (const float sign : {1.0f, -1.0f}) {
+                const float vs = vm * i / 8;
+                const float vt = vm * k / 8;
+                const float d = 1e-3f * std::pow(10.0f, l / 3.0f);
+                inputs.push_back({jm, am, vm, sign * vs, sign * vt, sign * d});
+              }
+  std::mt19937 mt(0);
+  std::uniform_real_distribution<float> unit(0, 1);
+  for (int n = 0; n < n_fuzz; ++n) {
+    const float jm = 50 * std::pow(10.0f, unit(mt));
+    const float am = 5 * std::pow(4.0f, unit(mt));
+    const float vm = 2 * std::pow(4.0f, unit(mt));
+    const float sign = unit(mt) < 0.5f ? 1 : -1;
+    const float vs = vm * unit(mt);
+    const float vt = vm * unit(mt);
+    const float d = 1e-3f * std::pow(10.0f, 4 * unit(mt));
+    inputs.push_back({jm, am, vm, sign * vs, sign * vt, sign * d});
+  }
+  return inputs;
+}
+
+static uint64_t percentile(const std::vector<uint64_t>& sorted,
+                           const double p) {
+  if (sorted.empty()) return 0;
+  const auto i = static_cast<std::size_t>(std::ceil(p * sorted.size()));
+  return sorted[std::min(sorted.size() - 1, i > 0 ? i - 1 : 0)];
+}
+
+__attribute__((noinline)) static float evalBranching(const AccelDesigner& ad,
+                                                    const float t) {
+  return ad.j(t) + ad.a(t) + ad.v(t) + ad.x(t);
+}
+
+__attribute__((noinline)) static float evalBranchless(const AccelDesigner& ad,
+                                                     const float t) {
+  return ad.jBranchless(t) + ad.aBranchless(t) + ad.vBranchless(t) +
+         ad.xBranchless(t);
+}
+
+/**
+ * @brief timing jitter of j, a, v, x at random times in random order
+ * @details each query is measured once so that branch mispredictions show up
+ */
+template <typename F>
+static std::vector<uint64_t> measureEval(F f, const AccelDesigner& ad,
+                                         const uint64_t overhead) {
+  std::mt19937 mt(1);
+  const float margin = (ad.t_end() - ad.t_0()) / 8;
+  std::uniform_real_distribution<float> urd(ad.t_0() - margin,
+                                            ad.t_end() + margin);
+  std::vector<uint64_t> times;
+  volatile float sink = 0;
+  for (int i = 0; i < 100000; ++i) {
+    const float t = urd(mt);
+    const auto ts = now();
+    sink = f(ad, t);
+    const auto te = now();
+    times.push_back(te - ts > overhead ? te - ts - overhead : 0);
+  }
+  (void)sink;
+  std::sort(times.begin(), times.end());
+  return times;
+}
+
+static std::ostream& operator<<(std::ostream& os, const Input& in) {
+  return os << "jm: " << in.jm << "\tam: " << in.am << "\tvm: " << in.vm
+            << "\tvs: " << in.vs << "\tvt: " << in.vt << "\td: " << in.d;
+}
+
+int main(int argc, char* argv[]) {
+  const int n_fuzz = argc > 1 ? std::atoi(argv[1]) : 200000;
+  const char* csv_name = argc > 2 ? argv[2] : "wcet.csv";
+  const int repeat = 7;
+  const auto inputs = makeInputs(n_fuzz);
+  AccelDesigner ad;
+  /* timer overhead */
+  uint64_t overhead = UINT64_MAX;
+  for (int i = 0; i < 1000; ++i)
+    overhead =
+        std::min(overhead, measure(empty, ad, inputs[0], repeat).first);
+  /* measurement */
+  struct Sample {
+    uint64_t time;
+    std::size_t index;
+  };
+  std::array<std::vector<Sample>, kPathNames.size()> samples;
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    /* the worst of the repetitions, not the best, for WCET */
+    const auto t = measure(run, ad, inputs[i], repeat).second;
+    samples[classify(inputs[i])].push_back(
+        {t > overhead ? t - overhead : 0, i});
+  }
+  /* report */
+  std::cout << "Inputs: " << inputs.size() << "\tRepeat: " << repeat
+            << "\tTimer Overhead: " << overhead << " [" << kUnit << "]"
+            << std::endl;
+  std::ofstream csv(csv_name);
+  csv << "path,bin_lo,bin_hi,count" << std::endl;
+  std::vector<uint64_t> all;
+  Sample worst{0, 0};
+  int worst_path = -1;
+  for (std::size_t p = 0; p < samples.size(); ++p) {
+    auto& s = samples[p];
+    if (s.empty()) continue;
+    std::sort(s.begin(), s.end(), [](const Sample& a, const Sample& b) {
+      return a.time < b.time;
+    });
+    std::vector<uint64_t> times;
+    for (const auto& e : s) times.push_back(e.time), all.push_back(e.time);
+    std::cout << std::setw(46) << std::left << kPathNames[p] << std::right
+              << "\tn: " << std::setw(7) << times.size()
+              << "\tmin: " << std::setw(5) << times.front()
+              << "\tp50: " << std::setw(5) << percentile(times, 0.5)
+              << "\tp99: " << std::setw(5) << percentile(times, 0.99)
+              << "\tp99.9: " << std::setw(5) << percentile(times, 0.999)
+              << "\tmax: " << std::setw(5) << times.back() << std::endl;
+    std::cout << "\tworst input: " << inputs[s.back().index] << std::endl;
+    if (s.back().time >= worst.time) worst = s.back(), worst_path = p;
+    /* histogram with 64 bins */
+    const uint64_t width = std::max<uint64_t>(1, (times.back() + 64) / 64);
+    std::vector<std::size_t> bins(times.back() / width + 1);
+    for (const auto t : times) ++bins[t / width];
+    for (std::size_t b = 0; b < bins.size(); ++b)
+      if (bins[b])
+        csv << '"' << kPathNames[p] << "\"," << b * width << ','
+            << (b + 1) * width << ',' << bins[b] << std::endl;
+  }
+  /* input region of the slowest 0.1 percent, in magnitudes since reset() is
+   * symmetric in the sign of the direction */
+  const auto magnitude = [](const Input& in) {
+    return Input{in.jm, in.am, in.vm,
+                 std::abs(in.vs), std::abs(in.vt), std::abs(in.d)};
+  };
+  std::sort(all.begin(), all.end());
+  const auto threshold = percentile(all, 0.999);
+  Input lo = magnitude(inputs[worst.index]), hi = lo;
+  std::array<std::size_t, kPathNames.size()> count{};
+  for (std::size_t p = 0; p < samples.size(); ++p)
+    for (const auto& e : samples[p]) {
+      if (e.time < threshold) continue;
+      const auto in = magnitude(inputs[e.index]);
+      ++count[p];
+      lo = {std::min(lo.jm, in.jm), std::min(lo.am, in.am),
+            std::min(lo.vm, in.vm), std::min(lo.vs, in.vs),
+            std::min(lo.vt, in.vt), std::min(lo.d, in.d)};
+      hi = {std::max(hi.jm, in.jm), std::max(hi.am, in.am),
+            std::max(hi.vm, in.vm), std::max(hi.vs, in.vs),
+            std::max(hi.vt, in.vt), std::max(hi.d, in.d)};
+    }
+  std::cout << "Overall p99.9: " << threshold << "\tmax: " << worst.time
+            << " [" << kUnit << "]" << std::endl;
+  std::cout << "Worst Path: " << kPathNames[worst_path] << std::endl;
+  std::cout << "Worst Input: " << inputs[worst.index] << std::endl;
+  std::cout << "Slowest 0.1% by path:";
+  for (std::size_t p = 0; p < count.size(); ++p)
+    if (count[p]) std::cout << "\n\t" << kPathNames[p] << ": " << count[p];
+  std::cout << std::endl;
+  /* evaluation jitter */
+  {
+    const AccelDesigner ad(100, 10, 4, 0, 2, 4);
+    std::cout << "Evaluation of j + a + v + x at random times [" << kUnit
+              << "]:" << std::endl;
+    for (const bool branchless : {false, true}) {
+      const auto times = branchless ? measureEval(evalBranchless, ad, overhead)
+                                    : measureEval(evalBranching, ad, overhead);
+      const auto p10 = percentile(times, 0.1);
+      const auto p90 = percentile(times, 0.9);
+      std::cout << (branchless ? "\tbranchless" : "\tbranching ")
+                << "\tp10: " << p10 << "\tp50: " << percentile(times, 0.5)
+                << "\tp90: " << p90 << "\tp99: " << percentile(times, 0.99)
+                << "\tp99.9: " << percentile(times, 0.999)
+                << "\tjitter (p90 - p10): " << p90 - p10 << std::endl;
+    }
+  }
+  std::cout << "Slowest 0.1% region (magnitudes):\n\tmin " << lo << "\n\tmax " << hi
+            << std::endl;
+
+  return 0;
+}
@@ -7,6 +7,8 @@
  */
 #define CTRL_LOG_LEVEL CTRL_LOG_LEVEL_INFO
 #include <ctrl/accel_designer.h>
+#include <ctrl/columnar.h>
+#include <ctrl/csv_writer.h>
 
 #include <chrono>
 #include <fstream>
@@ -16,20 +18,20 @@
 void printCsv(const std::string& filebase, const ctrl::AccelDesigner& ad) {
   ctrl_logi << ad << std::endl;
   const float Ts = 1e-4f;
-  std::ofstream of;
   const auto ticks = ad.getTimeStamps();
   float t = 0;
   for (size_t i = 0; i < ticks.size(); ++i) {
-    of = std::ofstream(filebase + "_" + std::to_string(i) + ".csv");
+    std::ofstream of(filebase + "_" + std::to_string(i) + ".csv");
+    ctrl::CsvWriter csv(of);
+    ctrl::ColumnarWriter bin(ctrl::ColumnarWriter::kAccelColumns);
     while (t + Ts < ticks[i]) {
-      of << t;
-      of << "," << ad.j(t);
-      of << "," << ad.a(t);
-      of << "," << ad.v(t);
-      of << "," << ad.x(t);
-      of << std::endl;
+      csv << t << ad.j(t) << ad.a(t) << ad.v(t) << ad.x(t);
+      csv.endRow();
+      bin << t << ad.j(t) << ad.a(t) << ad.v(t) << ad.x(t);
+      bin.endRow();
       t += Ts;
     }
+    bin.save(filebase + "_" + std::to_string(i) + ".mmcb");
   }
 }
 
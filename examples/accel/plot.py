@@ -2,22 +2,26 @@
 # -*- coding: utf-8 -*-
 # ============================================================================ #
 from matplotlib.ticker import ScalarFormatter
+import os
+import sys
 import numpy as np
 import matplotlib.pyplot as plt
 
+sys.path.append(os.path.join(os.path.dirname(__file__), '../../tools'))
+import columnar  # noqa: E402
+
 # ============================================================================ #
 # prepare figure
 fig_t, ax_t = plt.subplots(4, 1, figsize=(6, 8))
 
 # ============================================================================ #
 # plot
-filebase = f'./accel'  # t,j,a,v,x
+filebase = f'./accel'
 for i in range(8):
-    raw = np.loadtxt(f"{filebase}_{i}.csv", delimiter=',', ndmin=2)
-    if raw.size == 0:
-        raw = np.empty(shape=(0, 5))
-    t = raw[:, 0]
-    value = raw[:, 1:1+4]
+    # accel_i.mmcb (columns of ctrl::ColumnarWriter::kAccelColumns)
+    cols = columnar.load(f"{filebase}_{i}.mmcb")
+    t = cols['t']
+    value = np.column_stack([cols[k] for k in ['j', 'a', 'v', 'x']])
     # theta
     for k in range(4):
         ax_t[k].plot(t, value[:, k], lw=4)
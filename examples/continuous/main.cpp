@@ -6,6 +6,7 @@
  * @copyright Copyright 2020 Ryotaro Onuki <kerikun11+github@gmail.com>
  */
 #include <ctrl/accel_designer.h>
+#include <ctrl/csv_writer.h>
 
 #include <chrono>
 #include <fstream>
@@ -15,11 +16,12 @@
 ctrl::AccelDesigner ad;
 ctrl::AccelCurve ac;
 std::ofstream of("continuous.csv");
+ctrl::CsvWriter csv(of);
 
 void test(const float jm, const float am, const float vm, const float vs,
           const float vt, const float d, const float xs, const float ts) {
   ad.reset(jm, am, vm, vs, vt, d, xs, ts);
-  ad.printCsv(of);
+  printCsv(csv, ad);
   // std::cout << ad << std::endl;
 }
 
@@ -6,11 +6,14 @@
  * @copyright Copyright 2020 Ryotaro Onuki <kerikun11+github@gmail.com>
  */
 #include <ctrl/accel_designer.h>
+#include <ctrl/csv_writer.h>
 #include <ctrl/feedback_controller.h>
+#include <ctrl/sample_range.h>
 
 #include <fstream>
 
-std::ofstream csv("main.csv");
+std::ofstream of("main.csv");
+ctrl::CsvWriter csv(of);
 
 int main(void) {
   /* Feedforward Model and Feedback Gain */
@@ -25,27 +28,18 @@ int main(void) {
   const float Ts = 1e-3f;
   /* Control */
   feedback_controller.reset();
-  for (float t = 0; t < trajectory.t_end(); t += Ts) {
-    const float r = trajectory.v(t);   //< reference of output
-    const float y = trajectory.v(t);   //< measurement output
-    const float dr = trajectory.a(t);  //< differential of reference of output
-    const float dy = trajectory.a(t);  //< differential of measurement output
+  for (const auto& ref : samples(trajectory, Ts)) {
+    const float r = ref.v;   //< reference of output
+    const float y = ref.v;   //< measurement output
+    const float dr = ref.a;  //< differential of reference of output
+    const float dy = ref.a;  //< differential of measurement output
     const float u = feedback_controller.update(r, y, dr, dy, Ts);
     /* apply control input u here */
     /* csv output */
     const auto bd = feedback_controller.getBreakdown();
-    csv << t;
-    csv << "," << r;
-    csv << "," << y;
-    csv << "," << dr;
-    csv << "," << dy;
-    csv << "," << u;
-    csv << "," << bd.ff;
-    csv << "," << bd.fb;
-    csv << "," << bd.fbp;
-    csv << "," << bd.fbi;
-    csv << "," << bd.fbd;
-    csv << std::endl;
+    csv << ref.t << r << y << dr << dy << u;
+    csv << bd.ff << bd.fb << bd.fbp << bd.fbi << bd.fbd;
+    csv.endRow();
   }
 
   return 0;
@@ -0,0 +1,123 @@
+/**
+ * @file main.cpp
+ * @brief replay recorded telemetry through controllers with changed gains
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/csv_writer.h>
+#include <ctrl/replay.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ctrl;
+
+/**
+ * @brief read-only memory mapping of a telemetry file
+ */
+class TelemetryFile {
+ public:
+  explicit TelemetryFile(const char* filename) {
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < 1) return;
+    size = st.st_size;
+    addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) addr = nullptr;
+    if (addr) madvise(addr, size, MADV_SEQUENTIAL);
+  }
+  ~TelemetryFile() {
+    if (addr) munmap(addr, size);
+    if (fd >= 0) close(fd);
+  }
+  TelemetryFile(const TelemetryFile&) = delete;
+  TelemetryFile& operator=(const TelemetryFile&) = delete;
+  /* returns nullptr if the file is not a valid telemetry file */
+  const TelemetryRecord* records() const {
+    const TelemetryFileHeader expected;
+    if (!addr || size < sizeof(expected)) return nullptr;
+    TelemetryFileHeader header;
+    std::memcpy(&header, addr, sizeof(header));
+    if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) ||
+        header.version != kTelemetryVersion ||
+        header.record_size != expected.record_size)
+      return nullptr;
+    return reinterpret_cast<const TelemetryRecord*>(
+        static_cast<const char*>(addr) + sizeof(header));
+  }
+  std::size_t count() const {
+    return addr ? (size - sizeof(TelemetryFileHeader)) /
+                      sizeof(TelemetryRecord)
+                : 0;
+  }
+
+ private:
+  int fd = -1;
+  void* addr = nullptr;
+  std::size_t size = 0;
+};
+
+int main(int argc, char* argv[]) {
+  const char* filename = argc > 1 ? argv[1] : "telemetry.bin";
+  const TelemetryFile file(filename);
+  const auto records = file.records();
+  const auto n = file.count();
+  if (!records) {
+    std::cerr << "Invalid telemetry file: " << filename << std::endl;
+    return 1;
+  }
+  /* gain variants to replay */
+  std::vector<Replayer::Variant> variants;
+  for (const float omega_n : {5.0f, 10.0f, 15.0f, 20.0f})
+    for (const float Kp : {0.5f, 1.0f, 2.0f}) {
+      Replayer::Variant v;
+      v.tracker_gain.omega_n = omega_n;
+      v.model = {Polar(1, 1), Polar(0, 0)};
+      v.gain = {Polar(Kp, Kp), Polar(0, 0), Polar(0, 0)};
+      variants.push_back(v);
+    }
+  /* replay each variant in parallel over the same mapping */
+  const auto ts = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (std::size_t k = 0; k < variants.size(); ++k) {
+    threads.emplace_back([&, k]() {
+      std::ofstream of("replay_" + std::to_string(k) + ".csv");
+      CsvWriter csv(of);
+      csv.header({"tick", "v", "w", "dv", "dw", "u.tra", "u.rot", "diff.v",
+                  "diff.w", "diff.dv", "diff.dw", "diff.u.tra",
+                  "diff.u.rot"});
+      Replayer replayer(variants[k]);
+      replayer.run(records, n, [&](const TelemetryRecord& r,
+                                   const Replayer::Output& o) {
+        csv << r.tick;
+        csv << o.tracker.v << o.tracker.w << o.tracker.dv << o.tracker.dw;
+        csv << o.bd.u.tra << o.bd.u.rot;
+        csv << o.tracker.v - r.tracker.v << o.tracker.w - r.tracker.w;
+        csv << o.tracker.dv - r.tracker.dv << o.tracker.dw - r.tracker.dw;
+        csv << o.bd.u.tra - r.bd.u.tra << o.bd.u.rot - r.bd.u.rot;
+        csv.endRow();
+      });
+    });
+  }
+  for (auto& t : threads) t.join();
+  const auto te = std::chrono::steady_clock::now();
+  const auto dur =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(te - ts);
+  std::cout << "Records: " << n << ", Variants: " << variants.size()
+            << std::endl;
+  std::cout << "Average Time: " << dur.count() / (n * variants.size() + 1)
+            << " [ns/record]" << std::endl;
+
+  return 0;
+}
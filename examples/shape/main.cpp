@@ -5,6 +5,9 @@
  * @date 2020-05-04
  * @copyright Copyright 2020 Ryotaro Onuki <kerikun11+github@gmail.com>
  */
+#include <ctrl/columnar.h>
+#include <ctrl/csv_writer.h>
+#include <ctrl/library.h>
 #include <ctrl/slalom/trajectory.h>
 
 #include <filesystem>
@@ -64,23 +67,13 @@ void printCsv(const std::string& filebase, const slalom::Shape& ss,
   State s;
   st.reset(v, th_start, ss.straight_prev / v);
   const float Ts = 1e-5f;
-  const auto printCSV = [](std::ostream& os, const float t, const State& s) {
-    os << t;
-    os << "," << s.dddq.th;
-    os << "," << s.ddq.th;
-    os << "," << s.dq.th;
-    os << "," << s.q.th;
-    os << "," << s.dddq.x;
-    os << "," << s.ddq.x;
-    os << "," << s.dq.x;
-    os << "," << s.q.x;
-    os << "," << s.dddq.y;
-    os << "," << s.ddq.y;
-    os << "," << s.dq.y;
-    os << "," << s.q.y;
-    os << std::endl;
+  const auto printCSV = [](CsvWriter& csv, const float t, const State& s) {
+    csv << t;
+    csv << s.dddq.th << s.ddq.th << s.dq.th << s.q.th;
+    csv << s.dddq.x << s.ddq.x << s.dq.x << s.q.x;
+    csv << s.dddq.y << s.ddq.y << s.dq.y << s.q.y;
+    csv.endRow();
   };
-  std::ofstream of;
   const std::vector<float> ticks = {{
       st.getAccelDesigner().t_0(),
       st.getAccelDesigner().t_1(),
@@ -90,8 +83,15 @@ void printCsv(const std::string& filebase, const slalom::Shape& ss,
   }};
   float t = 0;
   for (size_t i = 0; i < ticks.size(); ++i) {
-    of = std::ofstream(filebase + "_" + std::to_string(i) + ".csv");
-    while (t < ticks[i]) st.update(s, t, Ts), printCSV(of, t, s), t += Ts;
+    std::ofstream of(filebase + "_" + std::to_string(i) + ".csv");
+    CsvWriter csv(of);
+    ColumnarWriter bin(ColumnarWriter::kStateColumns);
+    while (t < ticks[i]) {
+      st.update(s, t, Ts), printCSV(csv, t, s);
+      bin << t << s, bin.endRow();
+      t += Ts;
+    }
+    bin.save(filebase + "_" + std::to_string(i) + ".mmcb");
   }
 }
 
@@ -104,7 +104,6 @@ void printTrajectory() {
   printCsv("shape/shape_4", shapes[4].second);
   printCsv("shape/shape_5", shapes[5].second, pi / 4);
   printCsv("shape/shape_6", shapes[6].second, pi / 4);
-  printCsv("shape/shape_7", shapes[7].second);
 }
 
 void printTable() {
@@ -121,6 +120,25 @@ void printTable() {
   std::cout << std::endl;
 }
 
+void writeShapeLibrary() {
+  /* write the shapes as a binary table shared with tools and the robot */
+  std::vector<slalom::Shape> table;
+  for (const auto& [name, shape] : shapes) table.push_back(shape);
+  const std::string filename = "shape/shapes.mmlb";
+  if (!ctrl::saveLibrary(filename, table.data(), table.size())) {
+    std::cerr << "failed to write " << filename << std::endl;
+    return;
+  }
+  /* read back without parsing */
+  std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+  const auto size = static_cast<std::size_t>(ifs.tellg());
+  std::vector<uint32_t> buf((size + 3) / 4);
+  ifs.seekg(0).read(reinterpret_cast<char*>(buf.data()), size);
+  const LibraryView<slalom::Shape> view(buf.data(), size);
+  std::cout << filename << ": " << view.size() << " shapes, "
+            << (view.verify() ? "crc ok" : "crc error") << std::endl;
+}
+
 int main(void) {
   /* print definitions to stdout */
   printDefinitions();
@@ -131,5 +149,8 @@ int main(void) {
   /* print result table */
   printTable();
 
+  /* save shapes as a binary table */
+  writeShapeLibrary();
+
   return 0;
 }
@@ -5,6 +5,8 @@
  * @date 2020-05-04
  * @copyright Copyright 2020 Ryotaro Onuki <kerikun11+github@gmail.com>
  */
+#include <ctrl/columnar.h>
+#include <ctrl/csv_writer.h>
 #include <ctrl/slalom/trajectory.h>
 
 #include <cmath>
@@ -22,23 +24,13 @@ void printCsv(const std::string& filebase, const slalom::Shape& ss,
   State s;
   st.reset(v, th_start, ss.straight_prev / v);
   const float Ts = st.getTimeCurve() * 1e-5f;
-  const auto printCSV = [](std::ostream& os, const float t, const State& s) {
-    os << t;
-    os << "," << s.dddq.th;
-    os << "," << s.ddq.th;
-    os << "," << s.dq.th;
-    os << "," << s.q.th;
-    os << "," << s.dddq.x;
-    os << "," << s.ddq.x;
-    os << "," << s.dq.x;
-    os << "," << s.q.x;
-    os << "," << s.dddq.y;
-    os << "," << s.ddq.y;
-    os << "," << s.dq.y;
-    os << "," << s.q.y;
-    os << std::endl;
+  const auto printCSV = [](CsvWriter& csv, const float t, const State& s) {
+    csv << t;
+    csv << s.dddq.th << s.ddq.th << s.dq.th << s.q.th;
+    csv << s.dddq.x << s.ddq.x << s.dq.x << s.q.x;
+    csv << s.dddq.y << s.ddq.y << s.dq.y << s.q.y;
+    csv.endRow();
   };
-  std::ofstream of;
   const std::vector<float> ticks = {{
       st.getAccelDesigner().t_0(),
       st.getAccelDesigner().t_1(),
@@ -48,11 +40,17 @@ void printCsv(const std::string& filebase, const slalom::Shape& ss,
   }};
   float t = 0;
   for (size_t i = 0; i < ticks.size(); ++i) {
-    of = std::ofstream(filebase + "_" + std::to_string(i) + ".csv");
+    std::ofstream of(filebase + "_" + std::to_string(i) + ".csv");
+    CsvWriter csv(of);
     // const float k_slip = 2e-5f;
     const float k_slip = 0;
-    while (t < ticks[i])
-      st.update(s, t, Ts, k_slip), printCSV(of, t, s), t += Ts;
+    ColumnarWriter bin(ColumnarWriter::kStateColumns);
+    while (t < ticks[i]) {
+      st.update(s, t, Ts, k_slip), printCSV(csv, t, s);
+      bin << t << s, bin.endRow();
+      t += Ts;
+    }
+    bin.save(filebase + "_" + std::to_string(i) + ".mmcb");
   }
 }
 
@@ -2,9 +2,14 @@
 # -*- coding: utf-8 -*-
 # ============================================================================ #
 from matplotlib.ticker import ScalarFormatter
+import os
+import sys
 import numpy as np
 import matplotlib.pyplot as plt
 
+sys.path.append(os.path.join(os.path.dirname(__file__), '../../tools'))
+import columnar  # noqa: E402
+
 # ============================================================================ #
 # global settings
 # plt.rcParams["font.family"] = "IPAGothic"
@@ -18,18 +23,16 @@ fig_t, ax_t = plt.subplots(4, 1, figsize=(4, 6))
 # plot
 filebase = f'./slalom'
 for i in range(5):
-    # slalom_i.csv
-    # t,dddth,ddth,dth,th,dddx,ddx,dx,x,dddy,ddy,dy,y
-    raw = np.loadtxt(f"{filebase}_{i}.csv", delimiter=',', ndmin=2)
-    if raw.size == 0:
-        raw = np.empty(shape=(0, 13))
-    t = raw[:, 0]
-    th = raw[:, 1:1+4]
+    # slalom_i.mmcb (columns of ctrl::ColumnarWriter::kStateColumns)
+    cols = columnar.load(f"{filebase}_{i}.mmcb")
+    t = cols['t']
+    th = np.column_stack([cols[k] for k in
+                          ['dddq.th', 'ddq.th', 'dq.th', 'q.th']])
     th = th / np.pi * 180  # rad -> degree
-    x = raw[:, 5:5+4]
-    y = raw[:, 9:9+4]
+    x = cols['q.x']
+    y = cols['q.y']
     # xy
-    ax_xy.plot(x[:, -1], y[:, -1], lw=3)
+    ax_xy.plot(x, y, lw=3)
     # theta
     for k in range(4):
         ax_t[k].plot(t, th[:, k], lw=3)
@@ -0,0 +1,76 @@
+/**
+ * @file main.cpp
+ * @brief telemetry recording example
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-08
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/feedback_controller.h>
+#include <ctrl/straight/trajectory.h>
+#include <ctrl/telemetry.h>
+#include <ctrl/trajectory_tracker.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+using namespace ctrl;
+
+/* recorder is a static object; no heap allocation */
+static TelemetryRecorder<1024> recorder;
+
+int main(void) {
+  /* constants */
+  const float Ts = 0.001f;
+  /* trajectory tracker and feedback controller */
+  TrajectoryTracker tt(TrajectoryTracker::Gain{});
+  FeedbackController<Polar> fc({Polar(1, 1), Polar(0, 0)},
+                               {Polar(1, 1), Polar(0, 0), Polar(0, 0)});
+  straight::Trajectory trajectory;
+  trajectory.reset(240000, 6000, 1200, 0, 0, 90 * 32);
+  /* background dump task */
+  std::atomic<bool> running{true};
+  std::thread dumper([&]() {
+    std::ofstream of("telemetry.bin", std::ios::binary);
+    const TelemetryFileHeader header;
+    of.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    std::array<TelemetryRecord, 256> chunk;
+    for (bool last = false; !last;) {
+      last = !running.load();
+      std::size_t n;
+      while ((n = recorder.read(chunk.data(), chunk.size())) > 0)
+        of.write(reinterpret_cast<const char*>(chunk.data()),
+                 n * sizeof(TelemetryRecord));
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  /* control loop */
+  State s;
+  tt.reset();
+  fc.reset();
+  std::chrono::nanoseconds dur{0};
+  int n = 0;
+  for (float t = 0; t < trajectory.t_end(); t += Ts, ++n) {
+    trajectory.update(s, t);
+    const auto est_q = s.q;
+    const auto est_v = Polar(s.dq.x, 0);
+    const auto est_a = Polar(s.ddq.x, 0);
+    const auto ref = tt.update(est_q, est_v, est_a, s);
+    fc.update({ref.v, ref.w}, est_v, {ref.dv, ref.dw}, est_a, Ts);
+    const auto ts = std::chrono::steady_clock::now();
+    recorder.record(est_q, est_v, est_a, s, ref, fc.getBreakdown());
+    const auto te = std::chrono::steady_clock::now();
+    dur += te - ts;
+    /* emulate the rest of the control period */
+    if (n % 64 == 0) std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+  running = false;
+  dumper.join();
+  std::cout << "Records: " << n << ", Dropped: " << recorder.dropped()
+            << std::endl;
+  std::cout << "Average Time: " << dur.count() / n << " [ns]" << std::endl;
+
+  return 0;
+}
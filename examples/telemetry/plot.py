@@ -0,0 +1,39 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# ============================================================================ #
+import os
+import sys
+import matplotlib.pyplot as plt
+
+sys.path.append(os.path.join(os.path.dirname(__file__), '../../tools'))
+import telemetry  # noqa: E402
+
+# ============================================================================ #
+# load
+rec = telemetry.load('./telemetry.bin')
+t = rec['tick'] * 1e-3
+
+# ============================================================================ #
+# plot
+fig_t, ax_t = plt.subplots(3, 1, figsize=(6, 8))
+ax_t[0].plot(t, rec['ref.dq.x'], lw=3, label='reference')
+ax_t[0].plot(t, rec['est_v.tra'], lw=1, label='estimate')
+ax_t[0].set_ylabel('velocity [mm/s]')
+ax_t[1].plot(t, rec['tracker.v'], lw=3, label='v')
+ax_t[1].plot(t, rec['tracker.dv'] * 1e-3, lw=3, label='dv * 1e-3')
+ax_t[1].set_ylabel('tracker output')
+for k in ['ff', 'fb', 'u']:
+    ax_t[2].plot(t, rec[f'bd.{k}.tra'], lw=2, label=k)
+ax_t[2].set_ylabel('control input')
+for ax in ax_t:
+    ax.grid(which='both')
+    ax.legend()
+ax_t[-1].set_xlabel('time [s]')
+
+# ============================================================================ #
+# fit
+fig_t.tight_layout()
+
+# ============================================================================ #
+# show
+plt.show()
@@ -5,6 +5,8 @@
  * @date 2020-05-04
  * @copyright Copyright 2020 Ryotaro Onuki <kerikun11+github@gmail.com>
  */
+#include <ctrl/csv_writer.h>
+#include <ctrl/sample_range.h>
 #include <ctrl/straight/trajectory.h>
 #include <ctrl/trajectory_tracker.h>
 
@@ -14,30 +16,18 @@
 #include <iostream>
 
 std::ofstream of("trajectory.csv");
-std::ostream& os = of;
+ctrl::CsvWriter csv(of);
 
 using namespace ctrl;
 
 void printCsv(const float t, const State& s,
               const TrajectoryTracker::Result& ref) {
-  os << t;
-  os << "," << s.dddq.th;
-  os << "," << s.ddq.th;
-  os << "," << s.dq.th;
-  os << "," << s.q.th;
-  os << "," << s.dddq.x;
-  os << "," << s.ddq.x;
-  os << "," << s.dq.x;
-  os << "," << s.q.x;
-  os << "," << s.dddq.y;
-  os << "," << s.ddq.y;
-  os << "," << s.dq.y;
-  os << "," << s.q.y;
-  os << "," << ref.v;
-  os << "," << ref.w;
-  os << "," << ref.dv;
-  os << "," << ref.dw;
-  os << std::endl;
+  csv << t;
+  csv << s.dddq.th << s.ddq.th << s.dq.th << s.q.th;
+  csv << s.dddq.x << s.ddq.x << s.dq.x << s.q.x;
+  csv << s.dddq.y << s.ddq.y << s.dq.y << s.q.y;
+  csv << ref.v << ref.w << ref.dv << ref.dw;
+  csv.endRow();
 }
 
 int main(void) {
@@ -50,8 +40,6 @@ int main(void) {
   /* trajectory tracker */
   TrajectoryTracker::Gain gain;
   TrajectoryTracker tt(gain);
-  /* state variables */
-  State s;
   /* init */
   const float v_start = 0;
   const float d_straight = 90 * 4;
@@ -59,8 +47,7 @@ int main(void) {
     straight::Trajectory trajectory;
     trajectory.reset(j_max, a_max, v_max, v_start, v_slalom, d_straight);
     tt.reset(v_start);
-    for (float t = 0; t < trajectory.t_end(); t += Ts) {
-      trajectory.update(s, t);
+    for (const auto& [t, s] : samples(trajectory, Ts)) {
       const auto est_q = s.q;
       const auto est_v = Polar(s.dq.x, 0);
       const auto est_a = Polar(s.ddq.x, 0);
@@ -9,8 +9,11 @@
 #pragma once
 
 #include <array>
-#include <cmath>     //< for std::sqrt, std::cbrt
+#include <cmath>  //< for std::sqrt, std::cbrt
+#include <cstdint>
+#include <cstring>   //< for std::memcpy
 #include <iostream>  //< for std::cout
+#include <limits>
 #include <ostream>
 
 /* log level definition */
@@ -48,11 +51,94 @@
 #define ctrl_logd std::ostream(0)
 #endif
 
+/* evaluation mode; 1 to evaluate j, a, v, x without branches */
+#ifndef CTRL_ACCEL_CURVE_BRANCHLESS
+#define CTRL_ACCEL_CURVE_BRANCHLESS 0
+#endif
+/* 1 to solve the cubic of calcReachableVelocityEnd without cbrt, hypot,
+ * atan2 and cos, with a bounded error */
+#ifndef CTRL_ACCEL_CURVE_FAST_MATH
+#define CTRL_ACCEL_CURVE_FAST_MATH 0
+#endif
+
 /**
  * @brief 制御関係の名前空間
  */
 namespace ctrl {
 
+/**
+ * @brief 条件により2値の一方を分岐なしで選択する関数
+ * @details ビットマスクにより選択するので、条件によらず同じ命令列となる。
+ * @return c ? a : b
+ */
+inline float branchlessSelect(const bool c, const float a, const float b) {
+  uint32_t ua, ub;
+  std::memcpy(&ua, &a, sizeof(ua));
+  std::memcpy(&ub, &b, sizeof(ub));
+  const uint32_t mask = -static_cast<uint32_t>(c);
+  const uint32_t u = (ua & mask) | (ub & ~mask);
+  float r;
+  std::memcpy(&r, &u, sizeof(r));
+  return r;
+}
+
+/**
+ * @brief 実行時に与える最大躍度と最大加速度の組
+ *
+ * AccelCurve の計算で使う、最大躍度と最大加速度から決まる量を提供する。
+ * AccelLimitsFixed と同じ関数をもつ。
+ */
+struct AccelLimits {
+  float j_max; /**< @brief 最大躍度の大きさ [m/s/s/s], 正であること */
+  float a_max; /**< @brief 最大加速度の大きさ [m/s/s], 正であること */
+
+  /**
+   * @brief コンストラクタ
+   * @param[in] j_max 最大躍度の大きさ [m/s/s/s], 正であること
+   * @param[in] a_max 最大加速度の大きさ [m/s/s], 正であること
+   */
+  constexpr AccelLimits(const float j_max, const float a_max)
+      : j_max(j_max), a_max(a_max) {}
+  /** @brief 速度が曲線となる部分の時間 tc = a_max / j_max [s] */
+  constexpr float tc() const { return a_max / j_max; }
+  /** @brief j_max / a_max [1/s] */
+  constexpr float jOverA() const { return j_max / a_max; }
+  /** @brief x / a_max */
+  constexpr float divA(const float x) const { return x / a_max; }
+  /** @brief x / j_max */
+  constexpr float divJ(const float x) const { return x / j_max; }
+};
+
+/**
+ * @brief コンパイル時定数の最大躍度と最大加速度の組
+ *
+ * 除算と逆数をコンパイル時に畳み込み、実行時には乗算のみとなる。
+ * 逆数の乗算となるので、AccelLimits とは丸め誤差の分だけ結果が異なりうる。
+ * @code
+ * struct Limits {
+ *   static constexpr float j_max = 240000;
+ *   static constexpr float a_max = 6000;
+ * };
+ * AccelDesignerFixed<Limits> ad(1200, 0, 0, 180);
+ * @endcode
+ * @tparam L static constexpr float の j_max と a_max をもつ型
+ */
+template <typename L>
+struct AccelLimitsFixed {
+  static constexpr float j_max = L::j_max; /**< @brief 最大躍度 [m/s/s/s] */
+  static constexpr float a_max = L::a_max; /**< @brief 最大加速度 [m/s/s] */
+  static_assert(j_max > 0 && a_max > 0, "limits must be positive");
+
+  /** @brief 速度が曲線となる部分の時間 tc = a_max / j_max [s] */
+  static constexpr float tc() { return a_max / j_max; }
+  /** @brief j_max / a_max [1/s] */
+  static constexpr float jOverA() { return j_max / a_max; }
+  /** @brief x / a_max */
+  static constexpr float divA(const float x) { return x * (1 / a_max); }
+  /** @brief x / j_max */
+  static constexpr float divJ(const float x) { return x * (1 / j_max); }
+};
+
 /**
  * @brief 走行距離拘束のない曲線加速の軌道を生成するクラス
  *
@@ -91,18 +177,28 @@ class AccelCurve {
    */
   void reset(const float j_max, const float a_max, const float v_start,
              const float v_end) {
+    reset(AccelLimits(j_max, a_max), v_start, v_end);
+  }
+  /**
+   * @brief 最大躍度と最大加速度の組を与えて曲線を生成する関数
+   * @param[in] l       最大躍度と最大加速度 (AccelLimits または AccelLimitsFixed)
+   * @param[in] v_start 始点速度 [m/s]
+   * @param[in] v_end   終点速度 [m/s]
+   */
+  template <typename L>
+  void reset(const L& l, const float v_start, const float v_end) {
     /* 符号付きで代入 */
-    am = (v_end > v_start) ? a_max : -a_max;  //< 最大加速度の符号を決定
-    jm = (v_end > v_start) ? j_max : -j_max;  //< 最大躍度の符号を決定
+    am = (v_end > v_start) ? l.a_max : -l.a_max;  //< 最大加速度の符号を決定
+    jm = (v_end > v_start) ? l.j_max : -l.j_max;  //< 最大躍度の符号を決定
     /* 初期値と最終値を代入 */
     v0 = v_start;  //< 代入
     v3 = v_end;    //< 代入
     t0 = 0;        //< ここでは初期値をゼロとする
     x0 = 0;        //< ここでは初期値はゼロとする
     /* 速度が曲線となる部分の時間を決定 */
-    const auto tc = a_max / j_max;
-    /* 等加速度直線運動の時間を決定 */
-    const auto tm = (v3 - v0) / am - tc;
+    const auto tc = l.tc();
+    /* 等加速度直線運動の時間を決定; am は v3 - v0 と同符号 */
+    const auto tm = l.divA(std::abs(v3 - v0)) - tc;
     /* 等加速度直線運動の有無で分岐 */
     if (tm > 0) {
       /* 速度: 曲線 -> 直線 -> 曲線 */
@@ -116,7 +212,7 @@ class AccelCurve {
       x3 = x0 + (v0 + v3) / 2 * (t3 - t0);  //< v(t) グラフの台形の面積より
     } else {
       /* 速度: 曲線 -> 曲線 */
-      const auto tcp = std::sqrt((v3 - v0) / jm);  //< 変曲までの時間
+      const auto tcp = std::sqrt(l.divJ(std::abs(v3 - v0)));  //< 変曲までの時間
       t1 = t2 = t0 + tcp;
       t3 = t2 + tcp;
       v1 = v2 = (v0 + v3) / 2;  //< 対称性より中点となる
@@ -130,6 +226,55 @@ class AccelCurve {
    * @return 躍度 [m/s/s/s]
    */
   float j(const float t) const {
+#if CTRL_ACCEL_CURVE_BRANCHLESS
+    return jBranchless(t);
+#else
+    return jBranching(t);
+#endif
+  }
+  /**
+   * @brief 任意の時刻 t [s] における加速度 a [m/s/s] を返す関数
+   * @param[in] 時刻 t [s]
+   * @return 加速度 [m/s/s]
+   */
+  float a(const float t) const {
+#if CTRL_ACCEL_CURVE_BRANCHLESS
+    return aBranchless(t);
+#else
+    return aBranching(t);
+#endif
+  }
+  /**
+   * @brief 任意の時刻 t [s] における速度 v [m/s] を返す関数
+   * @param[in] 時刻 t [s]
+   * @return 速度 [m/s]
+   */
+  float v(const float t) const {
+#if CTRL_ACCEL_CURVE_BRANCHLESS
+    return vBranchless(t);
+#else
+    return vBranching(t);
+#endif
+  }
+  /**
+   * @brief 任意の時刻 t [s] における位置 x [m] を返す関数
+   * @param[in] 時刻 t [s]
+   * @return 位置 [m]
+   */
+  float x(const float t) const {
+#if CTRL_ACCEL_CURVE_BRANCHLESS
+    return xBranchless(t);
+#else
+    return xBranching(t);
+#endif
+  }
+  /**
+   * @brief 区間を分岐で選択して躍度 j [m/s/s/s]を返す関数
+   * @details CTRL_ACCEL_CURVE_BRANCHLESS によらず使用できる。
+   * @param[in] 時刻 t [s]
+   * @return 躍度 [m/s/s/s]
+   */
+  float jBranching(const float t) const {
     if (t <= t0)
       return 0;
     else if (t <= t1)
@@ -142,11 +287,12 @@ class AccelCurve {
       return 0;
   }
   /**
-   * @brief 任意の時刻 t [s] における加速度 a [m/s/s] を返す関数
+   * @brief 区間を分岐で選択して加速度 a [m/s/s]を返す関数
+   * @details CTRL_ACCEL_CURVE_BRANCHLESS によらず使用できる。
    * @param[in] 時刻 t [s]
    * @return 加速度 [m/s/s]
    */
-  float a(const float t) const {
+  float aBranching(const float t) const {
     if (t <= t0)
       return 0;
     else if (t <= t1)
@@ -159,11 +305,12 @@ class AccelCurve {
       return 0;
   }
   /**
-   * @brief 任意の時刻 t [s] における速度 v [m/s] を返す関数
+   * @brief 区間を分岐で選択して速度 v [m/s]を返す関数
+   * @details CTRL_ACCEL_CURVE_BRANCHLESS によらず使用できる。
    * @param[in] 時刻 t [s]
    * @return 速度 [m/s]
    */
-  float v(const float t) const {
+  float vBranching(const float t) const {
     if (t <= t0)
       return v0;
     else if (t <= t1)
@@ -176,11 +323,12 @@ class AccelCurve {
       return v3;
   }
   /**
-   * @brief 任意の時刻 t [s] における位置 x [m] を返す関数
+   * @brief 区間を分岐で選択して位置 x [m]を返す関数
+   * @details CTRL_ACCEL_CURVE_BRANCHLESS によらず使用できる。
    * @param[in] 時刻 t [s]
    * @return 位置 [m]
    */
-  float x(const float t) const {
+  float xBranching(const float t) const {
     if (t <= t0)
       return x0 + v0 * (t - t0);
     else if (t <= t1)
@@ -192,10 +340,52 @@ class AccelCurve {
     else
       return x3 + v3 * (t - t3);
   }
+  /**
+   * @brief 分岐なしで躍度 j [m/s/s/s] を返す関数
+   * @details 区間をビットマスクで選択し、統一した多項式を評価するので、
+   * 時刻によらず同じ命令列となる。結果は jBranching() と一致する。
+   * @param[in] 時刻 t [s]
+   * @return 躍度 [m/s/s/s]
+   */
+  float jBranchless(const float t) const { return segment(t).j; }
+  /**
+   * @brief 分岐なしで加速度 a [m/s/s] を返す関数
+   * @param[in] 時刻 t [s]
+   * @return 加速度 [m/s/s]
+   */
+  float aBranchless(const float t) const {
+    const auto s = segment(t);
+    const auto dt = t - s.t;
+    return s.a + s.j * dt;
+  }
+  /**
+   * @brief 分岐なしで速度 v [m/s] を返す関数
+   * @param[in] 時刻 t [s]
+   * @return 速度 [m/s]
+   */
+  float vBranchless(const float t) const {
+    const auto s = segment(t);
+    const auto dt = t - s.t;
+    return s.v + s.a * dt + s.j / 2 * dt * dt;
+  }
+  /**
+   * @brief 分岐なしで位置 x [m] を返す関数
+   * @param[in] 時刻 t [s]
+   * @return 位置 [m]
+   */
+  float xBranchless(const float t) const {
+    const auto s = segment(t);
+    const auto dt = t - s.t;
+    return s.x + s.v * dt + s.a / 2 * dt * dt + s.j / 6 * dt * dt * dt;
+  }
   /**
    * @brief 終点時刻 [s]
    */
   float t_end() const { return t3; }
+  /**
+   * @brief 始点速度 [m/s]
+   */
+  float v_start() const { return v0; }
   /**
    * @brief 終点速度 [m/s]
    */
@@ -220,6 +410,59 @@ class AccelCurve {
    * @brief 曲線加速の終了時刻 [s]
    */
   float t_3() const { return t3; }
+  /**
+   * @brief 区間の多項式の係数
+   * @details 区間内の値は基準時刻からの経過時間の3次多項式で表される。
+   */
+  struct Segment {
+    float t; /**< @brief 基準時刻 [s] */
+    float j; /**< @brief 躍度 [m/s/s/s] */
+    float a; /**< @brief 基準時刻の加速度 [m/s/s] */
+    float v; /**< @brief 基準時刻の速度 [m/s] */
+    float x; /**< @brief 基準時刻の位置 [m] */
+  };
+  /**
+   * @brief 区間の数; 開始前、躍度正、等加速度、躍度負、終了後
+   */
+  static constexpr int kSegments = 5;
+  /**
+   * @brief 区間 k の係数を返す関数
+   * @details 区間 k は時刻 segmentEnd(k - 1) < t <= segmentEnd(k) の範囲。
+   * 係数は分岐なしの評価で選択されるものと同じ。
+   * @param[in] k 区間の番号 (0 <= k < kSegments)
+   */
+  Segment segmentAt(const int k) const {
+    switch (k) {
+      case 0:
+        return {t0, 0, 0, v0, x0};
+      case 1:
+        return {t0, jm, 0, v0, x0};
+      case 2:
+        return {t1, 0, am, v1, x1};
+      case 3:
+        return {t3, -jm, 0, v3, x3};
+      default:
+        return {t3, 0, 0, v3, x3};
+    }
+  }
+  /**
+   * @brief 区間 k の終端時刻 [s] を返す関数
+   * @param[in] k 区間の番号 (0 <= k < kSegments)、最後の区間の終端は無限大
+   */
+  float segmentEnd(const int k) const {
+    switch (k) {
+      case 0:
+        return t0;
+      case 1:
+        return t1;
+      case 2:
+        return t2;
+      case 3:
+        return t3;
+      default:
+        return std::numeric_limits<float>::infinity();
+    }
+  }
   /**
    * @brief 境界のタイムスタンプをまとめて取得する関数
    */
@@ -228,12 +471,13 @@ class AccelCurve {
   }
   /**
    * @brief std::ostream に軌道のcsvを出力する関数
+   * @details 大量の行を出力する場合は、csv_writer.h の
+   * printCsv(CsvWriter&, const Curve&, float) を使用すること。
    */
   void printCsv(std::ostream& os, const float t_interval = 1e-3f) const {
-    for (float t = t0; t < t_end(); t += t_interval) {
+    for (float t = t0; t < t_end(); t += t_interval)
       os << t << "," << j(t) << "," << a(t) << "," << v(t) << "," << x(t)
-         << std::endl;
-    }
+         << "\n";
   }
   /**
    * @brief 情報の表示
@@ -263,19 +507,36 @@ class AccelCurve {
   static float calcReachableVelocityEnd(const float j_max, const float a_max,
                                         const float vs, const float vt,
                                         const float d) {
+    return calcReachableVelocityEnd(AccelLimits(j_max, a_max), vs, vt, d);
+  }
+  /**
+   * @brief 走行距離の拘束から達しうる終点速度を算出する関数
+   * @param[in] l  最大躍度と最大加速度 (AccelLimits または AccelLimitsFixed)
+   * @param[in] vs 始点速度 [m/s]
+   * @param[in] vt 目標速度 [m/s]
+   * @param[in] d  走行距離 [m]
+   * @param[out] branch 通った分岐 (オプション);
+   * 1: 曲線・直線・曲線, 2: 曲線・曲線 (加速), 3: 曲線・曲線 (減速)
+   * @return ve    終点速度 [m/s]
+   */
+  template <typename L>
+  static float calcReachableVelocityEnd(const L& l, const float vs,
+                                        const float vt, const float d,
+                                        int* const branch = nullptr) {
     /* 速度が曲線となる部分の時間を決定 */
-    const auto tc = a_max / j_max;
+    const auto tc = l.tc();
     /* 最大加速度の符号を決定 */
-    const auto am = (vt > vs) ? a_max : -a_max;
-    const auto jm = (vt > vs) ? j_max : -j_max;
+    const auto am = (vt > vs) ? l.a_max : -l.a_max;
+    const auto jm = (vt > vs) ? l.j_max : -l.j_max;
     /* 等加速度直線運動の有無で分岐 */
     const auto d_triangle = (vs + am * tc / 2) * tc;  //< distance @ tm == 0
-    const auto v_triangle = jm / am * d - vs;         //< v_end @ tm == 0
+    const auto v_triangle = l.jOverA() * d - vs;      //< v_end @ tm == 0
     // ctrl_logd << "d_tri: " << d_triangle << std::endl;
     // ctrl_logd << "v_tri: " << v_triangle << std::endl;
     if (d * v_triangle > 0 && std::abs(d) > std::abs(d_triangle)) {
       /* 曲線・直線・曲線 */
       ctrl_logd << "v: curve - straight - curve" << std::endl;
+      if (branch) *branch = 1;
       /* 2次方程式の解の公式を解く */
       const auto amtc = am * tc;
       const auto D = amtc * amtc - 4 * (amtc * vs - vs * vs - 2 * am * d);
@@ -287,22 +548,94 @@ class AccelCurve {
      * 簡単のため、値を一度すべて正に変換して、計算結果に符号を付与して返送 */
     const auto a = std::abs(vs);
     const auto b = (d > 0 ? 1 : -1) * jm * d * d;
+#if CTRL_ACCEL_CURVE_FAST_MATH
+    if (branch) *branch = 8 * (a * a * a / 27) / b + 1.0f / 4 >= 0 ? 2 : 3;
+    return (d > 0 ? 1 : -1) * solveReachableVelocityCubic(a, b);
+#else
     const auto aaa_27 = a * a * a / 27;
     const auto cr = 8 * aaa_27 + b / 2;
     const auto ci_b = 8 * aaa_27 / b + 1.0f / 4;
     if (ci_b >= 0) {
       /* ルートの中が非負のとき、3乗根により解を求める */
       ctrl_logd << "v: curve - curve (accel)" << std::endl;
+      if (branch) *branch = 2;
       const auto c = std::cbrt(cr + std::abs(b) * std::sqrt(ci_b));
       return (d > 0 ? 1 : -1) * (c + 4 * a * a / c / 9 - a / 3);
     } else {
       /* ルートの中が負のとき、極座標変換して解を求める */
       ctrl_logd << "v: curve - curve (decel)" << std::endl;
+      if (branch) *branch = 3;
       const auto ci = std::abs(b) * std::sqrt(-ci_b);
       const auto r = std::hypot(cr, ci);  //< = sqrt(cr^2 + ci^2)
       const auto th = std::atan2(ci, cr);
       return (d > 0 ? 1 : -1) * (2 * std::cbrt(r) * std::cos(th / 3) - a / 3);
     }
+#endif
+  }
+  /**
+   * @brief 曲線・曲線の終点速度の3次方程式 (u + a)^2 (u - a) = b を解く関数
+   *
+   * @details 最大の実数解 u を、3乗根や三角関数を使わずに求める。
+   * 解を含む区間 [lo, hi] を四則演算のみで求め、その区間で単調増加かつ凸な関数に対して、
+   * 上側をニュートン法、下側を割線法で更新して区間を縮める。
+   * 凸性により、ニュートン法の点は常に解以上、割線法の点は常に解以下となるので、
+   * 返り値 (区間の中点) と真の解との差は区間幅の半分以下であることが保証される。
+   * 誤差の上界には、関数値の丸め誤差の分として数 ulp を加える。
+   * 反復は最大 kSolverIterations 回で、区間幅が相対 kSolverTolerance 以下で打ち切る。
+   * @param[in] a 始点速度の大きさ、非負であること
+   * @param[in] b 方程式の右辺 (符号付きの躍度 × 走行距離の2乗)
+   * @param[out] error 解の誤差の上界 (オプション)
+   * @return u 最大の実数解
+   */
+  static float solveReachableVelocityCubic(const float a, const float b,
+                                           float* const error = nullptr) {
+    float sign = 1, lo, hi, c = a, r = b;
+    if (b >= 0) {
+      /* 解は a 以上; (u + a)^2 >= 4 a^2 および (u + a)^2 >= (u - a)^2 より */
+      lo = a;
+      hi = a + std::fmin(b / (4 * a * a), cbrtUpperBound(b));
+    } else if (-b <= 32 * a * a * a / 27) {
+      /* 3つの実数解のうち最大のものは [a/3, a] にある */
+      lo = a / 3;
+      hi = a;
+    } else {
+      /* 唯一の実数解は -a 以下; u = -v とおくと (v - a)^2 (v + a) = -b */
+      sign = -1, c = -a, r = -b;
+      lo = a;
+      hi = a + cbrtUpperBound(r);
+    }
+    /* g(u) = (u + c)^2 (u - c) - r は [lo, hi] で単調増加かつ凸 */
+    const auto g = [c, r](const float u) { return (u + c) * (u + c) * (u - c) - r; };
+    const auto dg = [c](const float u) { return (u + c) * (3 * u - c); };
+    float g_lo = g(lo), g_hi = g(hi);
+    for (int i = 0; i < kSolverIterations; ++i) {
+      if (hi - lo <= kSolverTolerance * hi || !(g_lo < 0 && g_hi > 0)) break;
+      /* 上側: ニュートン法 (凸なので接線の零点は解以上) */
+      const auto dg_hi = dg(hi);
+      const auto hi_next = dg_hi > 0 ? hi - g_hi / dg_hi : hi;
+      /* 下側: 割線法 (凸なので割線の零点は解以下) */
+      const auto lo_next = lo - g_lo * (hi - lo) / (g_hi - g_lo);
+      lo = std::fmax(lo, lo_next);
+      hi = std::fmin(hi, hi_next);
+      g_lo = g(lo);
+      g_hi = g(hi);
+    }
+    if (g_lo >= 0) hi = lo;  //< lo が解 (丸め誤差の範囲)
+    if (g_hi <= 0) lo = hi;  //< hi が解 (丸め誤差の範囲)
+    if (error) {
+      /* 解自体の丸め誤差と、関数値の丸め誤差 g_err による解のずれを加える;
+       * 重解付近 (-b = 32 a^3 / 27) では g' が 0 に近づくので、
+       * 2次の項による sqrt(2 dg / g'') で抑える */
+      const auto u = (lo + hi) / 2;
+      const auto eps = std::numeric_limits<float>::epsilon();
+      const auto g_err =
+          8 * eps * ((u + c) * (u + c) * std::abs(u - c) + std::abs(r));
+      const auto ddg = 6 * u + 2 * c;
+      *error = (hi - lo) / 2 + 2 * eps * u +
+               (g_err > 0 ? std::fmin(g_err / dg(u), std::sqrt(2 * g_err / ddg))
+                          : 0);
+    }
+    return sign * (lo + hi) / 2;
   }
   /**
    * @brief 走行距離の拘束から達しうる最大速度を算出する関数
@@ -316,9 +649,22 @@ class AccelCurve {
   static float calcReachableVelocityMax(const float j_max, const float a_max,
                                         const float vs, const float ve,
                                         const float d) {
+    return calcReachableVelocityMax(AccelLimits(j_max, a_max), vs, ve, d);
+  }
+  /**
+   * @brief 走行距離の拘束から達しうる最大速度を算出する関数
+   * @param[in] l  最大躍度と最大加速度 (AccelLimits または AccelLimitsFixed)
+   * @param[in] vs 始点速度 [m/s]
+   * @param[in] ve 終点速度 [m/s]
+   * @param[in] d  走行距離 [m]
+   * @return vm    最大速度 [m/s]
+   */
+  template <typename L>
+  static float calcReachableVelocityMax(const L& l, const float vs,
+                                        const float ve, const float d) {
     /* 速度が曲線となる部分の時間を決定 */
-    const auto tc = a_max / j_max;
-    const auto am = (d > 0) ? a_max : -a_max;  //< 加速方向は移動方向に依存
+    const auto tc = l.tc();
+    const auto am = (d > 0) ? l.a_max : -l.a_max;  //< 加速方向は移動方向に依存
     /* 2次方程式の解の公式を解く */
     const auto amtc = am * tc;
     const auto D = amtc * amtc - 2 * (vs + ve) * amtc + 4 * am * d +
@@ -346,21 +692,63 @@ class AccelCurve {
                                                   const float a_max,
                                                   const float v_start,
                                                   const float v_end) {
-    /* キャッシュ */
-    const auto ve_minus_vs = v_end - v_start;
-    /* 符号付きで代入 */
-    const auto am = (ve_minus_vs > 0) ? a_max : -a_max;
-    const auto jm = (ve_minus_vs > 0) ? j_max : -j_max;
+    return calcDistanceFromVelocityStartToEnd(AccelLimits(j_max, a_max),
+                                              v_start, v_end);
+  }
+  /**
+   * @brief 速度差の拘束から達しうる変位を算出する関数
+   * @param[in] l       最大躍度と最大加速度 (AccelLimits または AccelLimitsFixed)
+   * @param[in] v_start 始点速度 [m/s]
+   * @param[in] v_end   終点速度 [m/s]
+   * @return d          変位 [m]
+   */
+  template <typename L>
+  static float calcDistanceFromVelocityStartToEnd(const L& l,
+                                                  const float v_start,
+                                                  const float v_end) {
+    /* キャッシュ; 符号付きの最大加速度 am は速度差と同符号 */
+    const auto dv = std::abs(v_end - v_start);
     /* 速度が曲線となる部分の時間を決定 */
-    const auto tc = a_max / j_max;
+    const auto tc = l.tc();
     /* 等加速度直線運動の時間を決定 */
-    const auto tm = ve_minus_vs / am - tc;
+    const auto tm = l.divA(dv) - tc;
     /* 始点から終点までの時間を決定 */
-    const auto t_all =
-        (tm > 0) ? (tc + tm + tc) : (2 * std::sqrt(ve_minus_vs / jm));
+    const auto t_all = (tm > 0) ? (tc + tm + tc) : (2 * std::sqrt(l.divJ(dv)));
     return (v_start + v_end) / 2 * t_all;  //< 速度グラフの面積により
   }
 
+ protected:
+  static constexpr int kSolverIterations = 12; /**< @brief 反復の上限 */
+  static constexpr float kSolverTolerance = 1e-6f; /**< @brief 相対区間幅 */
+
+  /**
+   * @brief x^3 >= value を満たす 2 のべき乗 x を返す関数
+   * @param[in] value 正の値
+   */
+  static float cbrtUpperBound(const float value) {
+    int e;
+    std::frexp(value, &e);  //< value < 2^e
+    /* ceil(e / 3) */
+    return std::ldexp(1.0f, e >= 0 ? (e + 2) / 3 : -(-e / 3));
+  }
+  /**
+   * @brief 時刻 t を含む区間の係数を分岐なしで選択する関数
+   * @details 減速区間とそれ以降は終点 t3 を基準とする。
+   */
+  Segment segment(const float t) const {
+    const bool c1 = t > t0, c2 = t > t1, c3 = t > t2, c4 = t > t3;
+    Segment s;
+    s.t = branchlessSelect(c3, t3, branchlessSelect(c2, t1, t0));
+    s.j = branchlessSelect(
+        c4, 0,
+        branchlessSelect(c3, -jm,
+                         branchlessSelect(c2, 0, branchlessSelect(c1, jm, 0))));
+    s.a = branchlessSelect(c3, 0, branchlessSelect(c2, am, 0));
+    s.v = branchlessSelect(c3, v3, branchlessSelect(c2, v1, v0));
+    s.x = branchlessSelect(c3, x3, branchlessSelect(c2, x1, x0));
+    return s;
+  }
+
  protected:
   float jm;             /**< @brief 躍度定数 [m/s/s/s] */
   float am;             /**< @brief 加速度定数 [m/s/s] */
@@ -15,6 +15,7 @@
 #include <ostream>
 
 #include "accel_curve.h"
+#include "accel_profile.h"
 
 /**
  * @brief 制御関係の名前空間
@@ -22,187 +23,260 @@
 namespace ctrl {
 
 /**
- * @brief 拘束条件を満たす曲線加減速の軌道を生成するクラス
+ * @brief 曲線加減速の軌道を保持し、評価する基底クラス
  *
- * - 目標速度や移動距離などの拘束条件を満たす曲線加速軌道を生成する
- * - 任意の時刻 $t$ における躍度 $j(t)$、加速度 $a(t)$、速度 $v(t)$、位置 $x(t)$
- * を返す連続な関数を提供する
- * - 最大加速度 $a_{\\max}$ と始点速度 $v_s$
- * など拘束次第では目標速度 $v_t$ に達することができない場合があるので注意する
+ * - AccelDesigner と AccelDesignerFixed に共通の評価関数とアクセサを提供する
+ * - 曲線を生成する reset() は、最大躍度と最大加速度の与え方に応じて派生クラスが提供する
+ * - AccelDesignerFixed は AccelDesigner に変換できないので、
+ *   固定の制限値を実行時の制限値で上書きする reset() は呼べない
  */
-class AccelDesigner {
+class BasicAccelDesigner {
  public:
   /**
-   * @brief 初期化付きコンストラクタ
-   *
-   * @param[in] j_max     最大躍度の大きさ [m/s/s/s]、正であること
-   * @param[in] a_max     最大加速度の大きさ [m/s/s], 正であること
-   * @param[in] v_max     最大速度の大きさ [m/s]、正であること
-   * @param[in] v_start   始点速度 [m/s]
-   * @param[in] v_target  目標速度 [m/s]
-   * @param[in] dist      移動距離 [m]
-   * @param[in] x_start   始点位置 [m] (オプション)
-   * @param[in] t_start   始点時刻 [s] (オプション)
+   * @brief 曲線を復元するための最小限の走行パラメータを返す関数
+   * @details 移動距離は x_end() - x_0 とする。同じ始点位置に復元した曲線は、
+   * 始点位置が 0 または移動距離以上の大きさのとき元の曲線とビット単位で一致し、
+   * それ以外のときは移動距離の丸め誤差の範囲で一致する。
    */
-  AccelDesigner(const float j_max, const float a_max, const float v_max,
-                const float v_start, const float v_target, const float dist,
-                const float x_start = 0, const float t_start = 0) {
-    reset(j_max, a_max, v_max, v_start, v_target, dist, x_start, t_start);
+  AccelProfile profile() const {
+    return {ac.v_start(), ac.v_end(), dc.v_end(), x3 - x0};
   }
   /**
-   * @brief とりあえずインスタンス化を行う空のコンストラクタ
-   * @attention 別途 reset() により初期化すること。
+   * @brief 任意の時刻 t [s] における躍度 j [m/s/s/s] を返す関数
+   * @param[in] 時刻 t [s]
+   * @return 躍度 [m/s/s/s]
    */
-  AccelDesigner() { t0 = t1 = t2 = t3 = x0 = x3 = 0; }
+  float j(const float t) const {
+#if CTRL_ACCEL_CURVE_BRANCHLESS
+    return jBranchless(t);
+#else
+    return jBranching(t);
+#endif
+  }
   /**
-   * @brief 引数の拘束条件から曲線を生成する関数
-   *
-   * @details この関数によってもれなくすべての変数が初期化される。
-   * @param[in] j_max     最大躍度の大きさ [m/s/s/s]、正であること
-   * @param[in] a_max     最大加速度の大きさ [m/s/s], 正であること
-   * @param[in] v_max     最大速度の大きさ [m/s]、正であること
-   * @param[in] v_start   始点速度 [m/s]
-   * @param[in] v_target  目標速度 [m/s]
-   * @param[in] dist      移動距離 [m]
-   * @param[in] x_start   始点位置 [m] (オプション)
-   * @param[in] t_start   始点時刻 [s] (オプション)
+   * @brief 任意の時刻 t [s] における加速度 a [m/s/s] を返す関数
+   * @param[in] 時刻 t [s]
+   * @return 加速度 [m/s/s]
    */
-  void reset(const float j_max, const float a_max, const float v_max,
-             const float v_start, const float v_target, const float dist,
-             const float x_start = 0, const float t_start = 0) {
-    /* 目標速度に到達可能か、走行距離から終点速度を決定していく */
-    auto v_end = v_target;  //< 仮代入
-    /* 移動距離の拘束により、目標速度に達し得ない場合の処理 */
-    const auto dist_min = AccelCurve::calcDistanceFromVelocityStartToEnd(
-        j_max, a_max, v_start, v_end);
-    if (std::abs(dist) < std::abs(dist_min)) {
-      ctrl_logd << "vs -> ve != vt" << std::endl;
-      /* 目標速度$v_t$に向かい、走行距離$d$で到達し得る終点速度$v_e$を算出 */
-      v_end = AccelCurve::calcReachableVelocityEnd(j_max, a_max, v_start,
-                                                   v_target, dist);
-    }
-    /* 飽和速度の仮置き */
-    auto v_sat = dist > 0 ? std::max({v_start, v_max, v_end})
-                          : std::min({v_start, -v_max, v_end});
-    /* 曲線を生成 */
-    ac.reset(j_max, a_max, v_start, v_sat);  //< 加速部分
-    dc.reset(j_max, a_max, v_sat, v_end);    //< 減速部分
-    /* 最大速度まで加速すると走行距離の拘束を満たさない場合の処理 */
-    const auto d_sum = ac.x_end() + dc.x_end();
-    if (std::abs(dist) < std::abs(d_sum)) {
-      ctrl_logd << "vs -> vr -> ve" << std::endl;
-      /* 走行距離などの拘束から到達可能速度を算出 */
-      const auto v_rm = AccelCurve::calcReachableVelocityMax(
-          j_max, a_max, v_start, v_end, dist);
-      /* 無駄な減速を回避 */
-      v_sat = dist > 0 ? std::max({v_start, v_rm, v_end})
-                       : std::min({v_start, v_rm, v_end});
-      ac.reset(j_max, a_max, v_start, v_sat);  //< 加速
-      dc.reset(j_max, a_max, v_sat, v_end);    //< 減速
-    }
-    /* t23 = nan 回避; vs = ve = d = 0 のときに発生 */
-    if (std::abs(v_sat) < std::numeric_limits<float>::epsilon()) v_sat = 1;
-    /* 各定数の算出 */
-    const auto t23 = (dist - ac.x_end() - dc.x_end()) / v_sat;
-    x0 = x_start;
-    x3 = x_start + dist;
-    t0 = t_start;
-    t1 = t0 + ac.t_end();                     //< 曲線加速終了の時刻
-    t2 = t0 + ac.t_end() + t23;               //< 等速走行終了の時刻
-    t3 = t0 + ac.t_end() + t23 + dc.t_end();  //< 曲線減速終了の時刻
-#if 0
-    /* 出力のチェック */
-    const auto e = 0.01f;  //< 数値誤差分
-    bool show_info = false;
-    /* 飽和速度時間 */
-    if (t23 < 0) {
-      ctrl_logd << t23 << std::endl;
-      show_info = true;
-    }
-    /* 終点速度 */
-    if (std::abs(v_start - v_end) > e + std::abs(v_start - v_target)) {
-      std::cerr << "Error: Velocity Target!" << std::endl;
-      show_info = true;
-    }
-    /* 飽和速度 */
-    if (std::abs(v_sat) >
-        e + std::max({v_max, std::abs(v_start), std::abs(v_end)})) {
-      std::cerr << "Error: Velocity Saturation!" << std::endl;
-      show_info = true;
-    }
-    /* タイムスタンプ */
-    if (!(t0 <= t1 + e && t1 <= t2 + e && t2 <= t3 + e)) {
-      ctrl_loge << "Error: Time Point Relationship!" << std::endl;
-      show_info = true;
-    }
-    /* 入力情報の表示 */
-    if (show_info) {
-      ctrl_loge << "Constraints:"
-                << "\tj_max: " << j_max << "\ta_max: " << a_max
-                << "\tv_max: " << v_max << "\tv_start: " << v_start
-                << "\tv_target: " << v_target << "\tdist: " << dist
-                << std::endl;
-      ctrl_loge << "ad.reset(" << j_max << ", " << a_max << ", " << v_max
-                << ", " << v_start << ", " << v_target << ", " << dist << ");"
-                << std::endl;
-      /* 表示 */
-      ctrl_loge << "Time Stamp: "
-                << "\tt0: " << t0 << "\tt1: " << t1 << "\tt2: " << t2
-                << "\tt3: " << t3 << std::endl;
-      ctrl_loge << "Position:   "
-                << "\tx0: " << x0 << "\tx1: " << x0 + ac.x_end()
-                << "\tx2: " << x0 + (dist - dc.x_end()) << "\tx3: " << x3
-                << std::endl;
-      ctrl_loge << "Velocity:   "
-                << "\tv0: " << v_start << "\tv1: " << v(t1) << "\tv2: " << v(t2)
-                << "\tv3: " << v_end << std::endl;
-    }
+  float a(const float t) const {
+#if CTRL_ACCEL_CURVE_BRANCHLESS
+    return aBranchless(t);
+#else
+    return aBranching(t);
 #endif
   }
   /**
-   * @brief 任意の時刻 t [s] における躍度 j [m/s/s/s] を返す関数
+   * @brief 任意の時刻 t [s] における速度 v [m/s] を返す関数
+   * @param[in] 時刻 t [s]
+   * @return 速度 [m/s]
+   */
+  float v(const float t) const {
+#if CTRL_ACCEL_CURVE_BRANCHLESS
+    return vBranchless(t);
+#else
+    return vBranching(t);
+#endif
+  }
+  /**
+   * @brief 任意の時刻 t [s] における位置 x [m] を返す関数
+   * @param[in] 時刻 t [s]
+   * @return 位置 [m]
+   */
+  float x(const float t) const {
+#if CTRL_ACCEL_CURVE_BRANCHLESS
+    return xBranchless(t);
+#else
+    return xBranching(t);
+#endif
+  }
+  /**
+   * @brief 加速曲線と減速曲線を分岐で選択して躍度 j [m/s/s/s]を返す関数
+   * @details CTRL_ACCEL_CURVE_BRANCHLESS によらず使用できる。
    * @param[in] 時刻 t [s]
    * @return 躍度 [m/s/s/s]
    */
-  float j(const float t) const {
+  float jBranching(const float t) const {
     if (t < t2)
-      return ac.j(t - t0);
+      return ac.jBranching(t - t0);
     else
-      return dc.j(t - t2);
+      return dc.jBranching(t - t2);
   }
   /**
-   * @brief 任意の時刻 t [s] における加速度 a [m/s/s] を返す関数
+   * @brief 加速曲線と減速曲線を分岐で選択して加速度 a [m/s/s]を返す関数
+   * @details CTRL_ACCEL_CURVE_BRANCHLESS によらず使用できる。
    * @param[in] 時刻 t [s]
    * @return 加速度 [m/s/s]
    */
-  float a(const float t) const {
+  float aBranching(const float t) const {
     if (t < t2)
-      return ac.a(t - t0);
+      return ac.aBranching(t - t0);
     else
-      return dc.a(t - t2);
+      return dc.aBranching(t - t2);
   }
   /**
-   * @brief 任意の時刻 t [s] における速度 v [m/s] を返す関数
+   * @brief 加速曲線と減速曲線を分岐で選択して速度 v [m/s]を返す関数
+   * @details CTRL_ACCEL_CURVE_BRANCHLESS によらず使用できる。
    * @param[in] 時刻 t [s]
    * @return 速度 [m/s]
    */
-  float v(const float t) const {
+  float vBranching(const float t) const {
     if (t < t2)
-      return ac.v(t - t0);
+      return ac.vBranching(t - t0);
     else
-      return dc.v(t - t2);
+      return dc.vBranching(t - t2);
   }
   /**
-   * @brief 任意の時刻 t [s] における位置 x [m] を返す関数
+   * @brief 加速曲線と減速曲線を分岐で選択して位置 x [m]を返す関数
+   * @details CTRL_ACCEL_CURVE_BRANCHLESS によらず使用できる。
    * @param[in] 時刻 t [s]
    * @return 位置 [m]
    */
-  float x(const float t) const {
+  float xBranching(const float t) const {
     if (t < t2)
-      return x0 + ac.x(t - t0);
+      return x0 + ac.xBranching(t - t0);
     else
-      return x3 - dc.x_end() + dc.x(t - t2);
+      return x3 - dc.x_end() + dc.xBranching(t - t2);
+  }
+  /**
+   * @brief 分岐なしで躍度 j [m/s/s/s] を返す関数
+   * @details 加速曲線と減速曲線をアドレスの表引きで選択し、
+   * AccelCurve の分岐なしの評価を行う。結果は jBranching() と一致する。
+   * @param[in] 時刻 t [s]
+   * @return 躍度 [m/s/s/s]
+   */
+  float jBranchless(const float t) const {
+    const bool c = t < t2;
+    return curve(c).jBranchless(t - branchlessSelect(c, t0, t2));
+  }
+  /**
+   * @brief 分岐なしで加速度 a [m/s/s] を返す関数
+   * @param[in] 時刻 t [s]
+   * @return 加速度 [m/s/s]
+   */
+  float aBranchless(const float t) const {
+    const bool c = t < t2;
+    return curve(c).aBranchless(t - branchlessSelect(c, t0, t2));
+  }
+  /**
+   * @brief 分岐なしで速度 v [m/s] を返す関数
+   * @param[in] 時刻 t [s]
+   * @return 速度 [m/s]
+   */
+  float vBranchless(const float t) const {
+    const bool c = t < t2;
+    return curve(c).vBranchless(t - branchlessSelect(c, t0, t2));
+  }
+  /**
+   * @brief 分岐なしで位置 x [m] を返す関数
+   * @param[in] 時刻 t [s]
+   * @return 位置 [m]
+   */
+  float xBranchless(const float t) const {
+    const bool c = t < t2;
+    return branchlessSelect(c, x0, x3 - dc.x_end()) +
+           curve(c).xBranchless(t - branchlessSelect(c, t0, t2));
   }
+  /**
+   * @brief 時刻の昇順に躍度、加速度、速度、位置を評価する走査器
+   *
+   * - 現在の区間の多項式の係数を保持し、時刻が区間の終端を超えたときだけ
+   *   次の区間へ進むので、評価のたびに区間を探索しない
+   * - 一定周期で順に評価する rollout() などで使用する
+   * - 時刻は単調非減少で与えること
+   * - 区間の境界の扱いと多項式の形が j() などとは異なるので、
+   *   結果は j() などと丸め誤差の範囲で一致する
+   */
+  class Walker {
+   public:
+    /**
+     * @brief 躍度、加速度、速度、位置の組
+     */
+    struct Value {
+      float j; /**< @brief 躍度 [m/s/s/s] */
+      float a; /**< @brief 加速度 [m/s/s] */
+      float v; /**< @brief 速度 [m/s] */
+      float x; /**< @brief 位置 [m] */
+    };
+
+   public:
+    /**
+     * @brief コンストラクタ
+     * @param[in] ad 評価する曲線
+     */
+    explicit Walker(const BasicAccelDesigner& ad) { build(ad); }
+    /**
+     * @brief 時刻 t [s] における躍度、加速度、速度、位置をまとめて返す関数
+     * @details 区間の選択は 1 回で済む
+     */
+    Value at(const float t) {
+      const auto& p = seek(t);
+      const auto& s = p.s;
+      const auto dt = (t - p.t_offset) - s.t;
+      return {s.j, s.a + s.j * dt, s.v + s.a * dt + s.j / 2 * dt * dt,
+              p.x_offset +
+                  (s.x + s.v * dt + s.a / 2 * dt * dt + s.j / 6 * dt * dt * dt)};
+    }
+    /**
+     * @brief 時刻 t [s] における躍度 j [m/s/s/s] を返す関数
+     */
+    float j(const float t) { return at(t).j; }
+    /**
+     * @brief 時刻 t [s] における加速度 a [m/s/s] を返す関数
+     */
+    float a(const float t) { return at(t).a; }
+    /**
+     * @brief 時刻 t [s] における速度 v [m/s] を返す関数
+     */
+    float v(const float t) { return at(t).v; }
+    /**
+     * @brief 時刻 t [s] における位置 x [m] を返す関数
+     */
+    float x(const float t) { return at(t).x; }
+
+   private:
+    /**
+     * @brief 加速曲線と減速曲線の区間を通した数
+     */
+    static constexpr int kSegments = 2 * AccelCurve::kSegments;
+    /**
+     * @brief 曲線上に配置した区間
+     */
+    struct Piece {
+      AccelCurve::Segment s; /**< @brief 区間の係数 */
+      float t_offset;        /**< @brief 曲線の時刻の原点 [s] */
+      float x_offset;        /**< @brief 曲線の位置の原点 [m] */
+      float t_next;          /**< @brief 区間の終端時刻 [s] */
+    };
+    std::array<Piece, kSegments> pieces; /**< @brief 区間の表 */
+    int k = 0;                           /**< @brief 現在の区間の番号 */
+
+    /**
+     * @brief 区間の表を作る関数
+     * @details 加速曲線の終了後の区間は、減速曲線の開始時刻 t2 で終わる。
+     * 最後の区間の終端は無限大なので、走査は表の外に出ない。
+     */
+    void build(const BasicAccelDesigner& ad) {
+      for (int i = 0; i < kSegments; ++i) {
+        const bool c = i < AccelCurve::kSegments;
+        const auto& curve = ad.curve(c);
+        const int kc = c ? i : i - AccelCurve::kSegments;
+        auto& p = pieces[i];
+        p.s = curve.segmentAt(kc);
+        p.t_offset = c ? ad.t0 : ad.t2;
+        p.x_offset = c ? ad.x0 : ad.x3 - ad.dc.x_end();
+        p.t_next = c && kc == AccelCurve::kSegments - 1
+                       ? ad.t2
+                       : p.t_offset + curve.segmentEnd(kc);
+      }
+    }
+    /**
+     * @brief 時刻 t を含む区間まで進め、その区間を返す関数
+     */
+    const Piece& seek(const float t) {
+      while (t > pieces[k].t_next) ++k;
+      return pieces[k];
+    }
+  };
   /**
    * @brief 終点時刻 [s]
    */
@@ -254,16 +328,19 @@ class AccelDesigner {
   }
   /**
    * @brief std::ostream に軌道のcsvを出力する関数。
+   * @details 大量の行を出力する場合は、csv_writer.h の
+   * printCsv(CsvWriter&, const Curve&, float) を使用すること。
    */
   void printCsv(std::ostream& os, const float t_interval = 1e-3f) const {
     for (float t = t0; t < t_end(); t += t_interval)
       os << t << "," << j(t) << "," << a(t) << "," << v(t) << "," << x(t)
-         << std::endl;
+         << "\n";
   }
   /**
    * @brief 情報の表示
    */
-  friend std::ostream& operator<<(std::ostream& os, const AccelDesigner& obj) {
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const BasicAccelDesigner& obj) {
     os << "AccelDesigner:";
     os << "\td: " << obj.x3 - obj.x0;
     os << "\tvs: " << obj.ac.v(0);
@@ -276,6 +353,165 @@ class AccelDesigner {
     return os;
   }
 
+ protected:
+  /**
+   * @brief とりあえずインスタンス化を行う空のコンストラクタ
+   * @attention 派生クラスの reset() により初期化すること。
+   */
+  BasicAccelDesigner() { t0 = t1 = t2 = t3 = x0 = x3 = 0; }
+  /**
+   * @brief 最大躍度と最大加速度の組を与えて曲線を生成する関数
+   *
+   * @details 派生クラスの reset() の本体。
+   * @param[in] l         最大躍度と最大加速度 (AccelLimits または AccelLimitsFixed)
+   * @param[in] v_max     最大速度の大きさ [m/s]、正であること
+   * @param[in] v_start   始点速度 [m/s]
+   * @param[in] v_target  目標速度 [m/s]
+   * @param[in] dist      移動距離 [m]
+   * @param[in] x_start   始点位置 [m]
+   * @param[in] t_start   始点時刻 [s]
+   * @param[out] path     通った分岐 (オプション); ビット 0-1 は
+   * AccelCurve::calcReachableVelocityEnd の分岐 (0 は呼ばれなかった場合)、
+   * ビット 2 は AccelCurve::calcReachableVelocityMax が呼ばれたか
+   */
+  template <typename L>
+  void design(const L& l, const float v_max, const float v_start,
+              const float v_target, const float dist, const float x_start,
+              const float t_start, int* const path = nullptr) {
+    int branch = 0;
+    /* 目標速度に到達可能か、走行距離から終点速度を決定していく */
+    auto v_end = v_target;  //< 仮代入
+    /* 移動距離の拘束により、目標速度に達し得ない場合の処理 */
+    const auto dist_min =
+        AccelCurve::calcDistanceFromVelocityStartToEnd(l, v_start, v_end);
+    if (std::abs(dist) < std::abs(dist_min)) {
+      ctrl_logd << "vs -> ve != vt" << std::endl;
+      /* 目標速度$v_t$に向かい、走行距離$d$で到達し得る終点速度$v_e$を算出 */
+      v_end = AccelCurve::calcReachableVelocityEnd(l, v_start, v_target, dist,
+                                                   path ? &branch : nullptr);
+    }
+    /* 飽和速度の仮置き */
+    auto v_sat = dist > 0 ? std::max({v_start, v_max, v_end})
+                          : std::min({v_start, -v_max, v_end});
+    /* 曲線を生成 */
+    ac.reset(l, v_start, v_sat);  //< 加速部分
+    dc.reset(l, v_sat, v_end);    //< 減速部分
+    /* 最大速度まで加速すると走行距離の拘束を満たさない場合の処理 */
+    const auto d_sum = ac.x_end() + dc.x_end();
+    if (std::abs(dist) < std::abs(d_sum)) {
+      ctrl_logd << "vs -> vr -> ve" << std::endl;
+      branch |= 4;
+      /* 走行距離などの拘束から到達可能速度を算出 */
+      const auto v_rm =
+          AccelCurve::calcReachableVelocityMax(l, v_start, v_end, dist);
+      /* 無駄な減速を回避 */
+      v_sat = dist > 0 ? std::max({v_start, v_rm, v_end})
+                       : std::min({v_start, v_rm, v_end});
+      ac.reset(l, v_start, v_sat);  //< 加速
+      dc.reset(l, v_sat, v_end);    //< 減速
+    }
+    /* 各定数の算出 */
+    place(v_sat, dist, x_start, t_start);
+    if (path) *path = branch;
+#if 0
+    const auto t23 = t2 - t1;
+    /* 出力のチェック */
+    const auto e = 0.01f;  //< 数値誤差分
+    bool show_info = false;
+    /* 飽和速度時間 */
+    if (t23 < 0) {
+      ctrl_logd << t23 << std::endl;
+      show_info = true;
+    }
+    /* 終点速度 */
+    if (std::abs(v_start - v_end) > e + std::abs(v_start - v_target)) {
+      std::cerr << "Error: Velocity Target!" << std::endl;
+      show_info = true;
+    }
+    /* 飽和速度 */
+    if (std::abs(v_sat) >
+        e + std::max({v_max, std::abs(v_start), std::abs(v_end)})) {
+      std::cerr << "Error: Velocity Saturation!" << std::endl;
+      show_info = true;
+    }
+    /* タイムスタンプ */
+    if (!(t0 <= t1 + e && t1 <= t2 + e && t2 <= t3 + e)) {
+      ctrl_loge << "Error: Time Point Relationship!" << std::endl;
+      show_info = true;
+    }
+    /* 入力情報の表示 */
+    if (show_info) {
+      ctrl_loge << "Constraints:"
+                << "\tj_max: " << l.j_max << "\ta_max: " << l.a_max
+                << "\tv_max: " << v_max << "\tv_start: " << v_start
+                << "\tv_target: " << v_target << "\tdist: " << dist
+                << std::endl;
+      ctrl_loge << "ad.reset(" << l.j_max << ", " << l.a_max << ", " << v_max
+                << ", " << v_start << ", " << v_target << ", " << dist << ");"
+                << std::endl;
+      /* 表示 */
+      ctrl_loge << "Time Stamp: "
+                << "\tt0: " << t0 << "\tt1: " << t1 << "\tt2: " << t2
+                << "\tt3: " << t3 << std::endl;
+      ctrl_loge << "Position:   "
+                << "\tx0: " << x0 << "\tx1: " << x0 + ac.x_end()
+                << "\tx2: " << x0 + (dist - dc.x_end()) << "\tx3: " << x3
+                << std::endl;
+      ctrl_loge << "Velocity:   "
+                << "\tv0: " << v_start << "\tv1: " << v(t1) << "\tv2: " << v(t2)
+                << "\tv3: " << v_end << std::endl;
+    }
+#endif
+  }
+  /**
+   * @brief 走行パラメータから曲線を復元する関数
+   *
+   * @details 到達可能速度の算出は行わず、2つの曲線の生成のみとなる。
+   * @param[in] l       最大躍度と最大加速度 (AccelLimits または AccelLimitsFixed)
+   * @param[in] p       走行パラメータ
+   * @param[in] x_start 始点位置 [m]
+   * @param[in] t_start 始点時刻 [s]
+   */
+  template <typename L>
+  void restore(const L& l, const AccelProfile& p, const float x_start,
+               const float t_start) {
+    ac.reset(l, p.v_start, p.v_sat);  //< 加速
+    dc.reset(l, p.v_sat, p.v_end);    //< 減速
+    place(p.v_sat, p.dist, x_start, t_start);
+  }
+  /**
+   * @brief 生成済みの曲線を配置して、境界点の時刻と位置を算出する関数
+   * @details 等速区間の時間は、始点と終点の位置の差から算出する。
+   * 量子化した走行パラメータ (AccelProfile16) から復元した場合など、
+   * 飽和速度が移動距離に対して大きすぎて等速区間の時間が負となるときは 0
+   * とする。このとき、位置は等速区間の始点で誤差の分だけ不連続となる。
+   * @param[in] v_sat   飽和速度 [m/s]
+   * @param[in] dist    移動距離 [m]
+   * @param[in] x_start 始点位置 [m]
+   * @param[in] t_start 始点時刻 [s]
+   */
+  void place(float v_sat, const float dist, const float x_start,
+             const float t_start) {
+    /* t23 = nan 回避; vs = ve = d = 0 のときに発生 */
+    if (std::abs(v_sat) < std::numeric_limits<float>::epsilon()) v_sat = 1;
+    /* 各定数の算出 */
+    x0 = x_start;
+    x3 = x_start + dist;
+    const auto t23 =
+        std::max(0.0f, ((x3 - x0) - ac.x_end() - dc.x_end()) / v_sat);
+    t0 = t_start;
+    t1 = t0 + ac.t_end();                     //< 曲線加速終了の時刻
+    t2 = t0 + ac.t_end() + t23;               //< 等速走行終了の時刻
+    t3 = t0 + ac.t_end() + t23 + dc.t_end();  //< 曲線減速終了の時刻
+  }
+  /**
+   * @brief 加速曲線 (c == true) または減速曲線を分岐なしで選択する関数
+   */
+  const AccelCurve& curve(const bool c) const {
+    const AccelCurve* const curves[2] = {&dc, &ac};
+    return *curves[c];
+  }
+
  protected:
   float t0, t1, t2, t3; /**< @brief 境界点の時刻 [s] */
   float x0, x3;         /**< @brief 境界点の位置 [m] */
@@ -283,4 +519,157 @@ class AccelDesigner {
   AccelCurve dc;        /**< @brief 曲線減速用オブジェクト */
 };
 
+/**
+ * @brief 拘束条件を満たす曲線加減速の軌道を生成するクラス
+ *
+ * - 目標速度や移動距離などの拘束条件を満たす曲線加速軌道を生成する
+ * - 任意の時刻 $t$ における躍度 $j(t)$、加速度 $a(t)$、速度 $v(t)$、位置 $x(t)$
+ * を返す連続な関数を提供する
+ * - 最大加速度 $a_{\\max}$ と始点速度 $v_s$
+ * など拘束次第では目標速度 $v_t$ に達することができない場合があるので注意する
+ */
+class AccelDesigner : public BasicAccelDesigner {
+ public:
+  /**
+   * @brief 初期化付きコンストラクタ
+   *
+   * @param[in] j_max     最大躍度の大きさ [m/s/s/s]、正であること
+   * @param[in] a_max     最大加速度の大きさ [m/s/s], 正であること
+   * @param[in] v_max     最大速度の大きさ [m/s]、正であること
+   * @param[in] v_start   始点速度 [m/s]
+   * @param[in] v_target  目標速度 [m/s]
+   * @param[in] dist      移動距離 [m]
+   * @param[in] x_start   始点位置 [m] (オプション)
+   * @param[in] t_start   始点時刻 [s] (オプション)
+   */
+  AccelDesigner(const float j_max, const float a_max, const float v_max,
+                const float v_start, const float v_target, const float dist,
+                const float x_start = 0, const float t_start = 0) {
+    reset(j_max, a_max, v_max, v_start, v_target, dist, x_start, t_start);
+  }
+  /**
+   * @brief 走行パラメータから復元するコンストラクタ
+   *
+   * @param[in] j_max     最大躍度の大きさ [m/s/s/s]、正であること
+   * @param[in] a_max     最大加速度の大きさ [m/s/s], 正であること
+   * @param[in] p         走行パラメータ
+   * @param[in] x_start   始点位置 [m] (オプション)
+   * @param[in] t_start   始点時刻 [s] (オプション)
+   */
+  AccelDesigner(const float j_max, const float a_max, const AccelProfile& p,
+                const float x_start = 0, const float t_start = 0) {
+    reset(j_max, a_max, p, x_start, t_start);
+  }
+  /**
+   * @brief とりあえずインスタンス化を行う空のコンストラクタ
+   * @attention 別途 reset() により初期化すること。
+   */
+  AccelDesigner() {}
+  /**
+   * @brief 引数の拘束条件から曲線を生成する関数
+   *
+   * @details この関数によってもれなくすべての変数が初期化される。
+   * @param[in] j_max     最大躍度の大きさ [m/s/s/s]、正であること
+   * @param[in] a_max     最大加速度の大きさ [m/s/s], 正であること
+   * @param[in] v_max     最大速度の大きさ [m/s]、正であること
+   * @param[in] v_start   始点速度 [m/s]
+   * @param[in] v_target  目標速度 [m/s]
+   * @param[in] dist      移動距離 [m]
+   * @param[in] x_start   始点位置 [m] (オプション)
+   * @param[in] t_start   始点時刻 [s] (オプション)
+   */
+  void reset(const float j_max, const float a_max, const float v_max,
+             const float v_start, const float v_target, const float dist,
+             const float x_start = 0, const float t_start = 0) {
+    design(AccelLimits(j_max, a_max), v_max, v_start, v_target, dist, x_start,
+           t_start);
+  }
+  /**
+   * @brief 走行パラメータから曲線を復元する関数
+   *
+   * @details profile() で得たパラメータから、同じ曲線を再計算なしで復元する。
+   * @param[in] j_max     最大躍度の大きさ [m/s/s/s]、正であること
+   * @param[in] a_max     最大加速度の大きさ [m/s/s], 正であること
+   * @param[in] p         走行パラメータ
+   * @param[in] x_start   始点位置 [m] (オプション)
+   * @param[in] t_start   始点時刻 [s] (オプション)
+   */
+  void reset(const float j_max, const float a_max, const AccelProfile& p,
+             const float x_start = 0, const float t_start = 0) {
+    restore(AccelLimits(j_max, a_max), p, x_start, t_start);
+  }
+};
+
+/**
+ * @brief 最大躍度と最大加速度をコンパイル時定数とした AccelDesigner
+ *
+ * - 最大躍度と最大加速度が固定の場合に、reset() で毎回行う除算を
+ *   コンパイル時の定数と逆数の乗算に置き換える
+ * - reset() の引数から j_max, a_max を除いたほかは AccelDesigner と同じ API
+ * - 共通の関数は BasicAccelDesigner として受け取ること
+ * - 逆数の乗算となるので、AccelDesigner とは丸め誤差の分だけ結果が異なりうる
+ * @code
+ * struct Limits {
+ *   static constexpr float j_max = 240000;
+ *   static constexpr float a_max = 6000;
+ * };
+ * AccelDesignerFixed<Limits> ad(1200, 0, 0, 180);
+ * straight::BasicTrajectory<AccelDesignerFixed<Limits>> trajectory;
+ * @endcode
+ * @tparam L static constexpr float の j_max と a_max をもつ型
+ */
+template <typename L>
+class AccelDesignerFixed : public BasicAccelDesigner {
+ public:
+  using Limits = AccelLimitsFixed<L>; /**< @brief 最大躍度と最大加速度 */
+
+ public:
+  /**
+   * @brief 初期化付きコンストラクタ
+   *
+   * @param[in] v_max     最大速度の大きさ [m/s]、正であること
+   * @param[in] v_start   始点速度 [m/s]
+   * @param[in] v_target  目標速度 [m/s]
+   * @param[in] dist      移動距離 [m]
+   * @param[in] x_start   始点位置 [m] (オプション)
+   * @param[in] t_start   始点時刻 [s] (オプション)
+   */
+  AccelDesignerFixed(const float v_max, const float v_start,
+                     const float v_target, const float dist,
+                     const float x_start = 0, const float t_start = 0) {
+    reset(v_max, v_start, v_target, dist, x_start, t_start);
+  }
+  /**
+   * @brief とりあえずインスタンス化を行う空のコンストラクタ
+   * @attention 別途 reset() により初期化すること。
+   */
+  AccelDesignerFixed() {}
+  /**
+   * @brief 引数の拘束条件から曲線を生成する関数
+   *
+   * @param[in] v_max     最大速度の大きさ [m/s]、正であること
+   * @param[in] v_start   始点速度 [m/s]
+   * @param[in] v_target  目標速度 [m/s]
+   * @param[in] dist      移動距離 [m]
+   * @param[in] x_start   始点位置 [m] (オプション)
+   * @param[in] t_start   始点時刻 [s] (オプション)
+   */
+  void reset(const float v_max, const float v_start, const float v_target,
+             const float dist, const float x_start = 0,
+             const float t_start = 0) {
+    design(Limits(), v_max, v_start, v_target, dist, x_start, t_start);
+  }
+  /**
+   * @brief 走行パラメータから曲線を復元する関数
+   *
+   * @param[in] p         走行パラメータ
+   * @param[in] x_start   始点位置 [m] (オプション)
+   * @param[in] t_start   始点時刻 [s] (オプション)
+   */
+  void reset(const AccelProfile& p, const float x_start = 0,
+             const float t_start = 0) {
+    restore(Limits(), p, x_start, t_start);
+  }
+};
+
 }  // namespace ctrl
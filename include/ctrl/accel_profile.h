@@ -0,0 +1,101 @@
+/**
+ * @file accel_profile.h
+ * @brief 曲線加減速の軌道を復元するための最小限の走行パラメータ
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#pragma once
+
+#include <algorithm>  //< for std::max, std::min
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 制御関係の名前空間
+ */
+namespace ctrl {
+
+/**
+ * @brief AccelDesigner の軌道を復元するための走行パラメータ
+ *
+ * - 最大躍度と最大加速度が既知であれば、この4値から軌道を復元できる
+ * - 到達可能速度は算出済みなので、復元時に3次方程式などを解く必要がない
+ * - AccelDesigner::profile() で取得し、AccelDesigner::reset() で復元する
+ */
+struct AccelProfile {
+  float v_start; /**< @brief 始点速度 [m/s] */
+  float v_sat;   /**< @brief 飽和速度 [m/s] */
+  float v_end;   /**< @brief 終点速度 [m/s] */
+  float dist;    /**< @brief 移動距離 [m] */
+};
+
+/**
+ * @brief AccelProfile16 の量子化の単位
+ */
+struct AccelProfileScale {
+  float v_unit; /**< @brief 速度の単位 [m/s] */
+  float x_unit; /**< @brief 距離の単位 [m] */
+
+  /**
+   * @brief 走行パラメータの配列がちょうど収まる単位を求める関数
+   * @param[in] profiles 走行パラメータの配列
+   * @param[in] n 要素数
+   */
+  static AccelProfileScale fit(const AccelProfile* profiles,
+                               const std::size_t n) {
+    float v_abs = 0, x_abs = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto& p = profiles[i];
+      v_abs = std::max({v_abs, std::abs(p.v_start), std::abs(p.v_sat),
+                        std::abs(p.v_end)});
+      x_abs = std::max(x_abs, std::abs(p.dist));
+    }
+    /* ゼロ除算の回避 */
+    const auto unit = [](const float abs) {
+      return abs > 0 ? abs / INT16_MAX : 1.0f;
+    };
+    return {unit(v_abs), unit(x_abs)};
+  }
+};
+
+/**
+ * @brief 16ビット整数に量子化した走行パラメータ
+ *
+ * - AccelProfile の半分、AccelDesigner の 1/17 の大きさとなる
+ * - 単位 AccelProfileScale は、ライブラリ全体で共有することを想定する
+ * - 各値の量子化誤差は単位の半分以下となる
+ */
+struct AccelProfile16 {
+  int16_t v_start; /**< @brief 始点速度 [v_unit] */
+  int16_t v_sat;   /**< @brief 飽和速度 [v_unit] */
+  int16_t v_end;   /**< @brief 終点速度 [v_unit] */
+  int16_t dist;    /**< @brief 移動距離 [x_unit] */
+
+  /**
+   * @brief 走行パラメータを量子化する関数
+   * @param[in] p 走行パラメータ
+   * @param[in] s 量子化の単位; 範囲外の値は飽和する
+   */
+  static AccelProfile16 pack(const AccelProfile& p,
+                             const AccelProfileScale& s) {
+    const auto q = [](const float value, const float unit) {
+      const auto i = std::lround(value / unit);
+      return static_cast<int16_t>(
+          std::min<long>(std::max<long>(i, INT16_MIN), INT16_MAX));
+    };
+    return {q(p.v_start, s.v_unit), q(p.v_sat, s.v_unit),
+            q(p.v_end, s.v_unit), q(p.dist, s.x_unit)};
+  }
+  /**
+   * @brief 走行パラメータを復元する関数
+   * @param[in] s 量子化の単位; pack() と同じであること
+   */
+  AccelProfile unpack(const AccelProfileScale& s) const {
+    return {v_start * s.v_unit, v_sat * s.v_unit, v_end * s.v_unit,
+            dist * s.x_unit};
+  }
+};
+
+}  // namespace ctrl
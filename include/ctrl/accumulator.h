@@ -7,44 +7,59 @@
  */
 #pragma once
 
-#include <new>
+#include <array>
+#include <cstddef>
+#include <type_traits>
 
 namespace ctrl {
 
 /**
  * @brief データの蓄積器
- * @tparam T データの型
+ *
+ * - バッファはオブジェクト内に確保され、ヒープを使用しない
+ * - S が 2 のべき乗のとき、剰余の代わりにビットマスクで添字を算出する
+ * - バッファ全体の和を逐次更新するので、全体の平均は O(1) で得られる
+ * - 浮動小数点数では、和の丸め誤差の累積を防ぐため、
+ *   バッファを一周する間に追加されたデータの和を別途求めておき、
+ *   一周するごとに全体の和と置き換える (最悪 O(1))
+ *
+ * @tparam T データの型; 加算、減算、スカラーとの除算ができること
  * @tparam S 蓄積するデータの数
  */
 template <typename T, std::size_t S>
 class Accumulator {
+  static_assert(S > 0, "S must be positive");
+
  public:
   /**
    * @brief コンストラクタ
    * @param[in] value バッファ内の全データに代入する初期値
    */
-  Accumulator(const T& value = T()) {
-    buffer = new T[S];
-    head = 0;
-    clear(value);
-  }
-  /**
-   * @brief デストラクタ
-   */
-  ~Accumulator() { delete[] buffer; }
+  Accumulator(const T& value = T()) { clear(value); }
   /**
    * @brief バッファをクリアする関数
    * @param[in] value 代入する値
    */
   void clear(const T& value = T()) {
-    for (int i = 0; i < S; i++) buffer[i] = value;
+    buffer.fill(value);
+    head = 0;
+    sum_ = T();
+    for (const auto& v : buffer) sum_ += v;
+    lap_sum = T();
   }
   /**
    * @brief 最新のデータを追加する関数
    */
   void push(const T& value) {
-    head = (head + 1) % S;
+    head = wrap(head + 1);
+    sum_ -= buffer[head];
+    sum_ += value;
     buffer[head] = value;
+    if constexpr (!std::is_integral<T>::value) {
+      lap_sum += value;
+      /* 一周したので、バッファ全体が今回の周回のデータとなる */
+      if (head == 0) sum_ = lap_sum, lap_sum = T();
+    }
   }
   /**
    * @brief 直近 index 番目の値を取得するオペレータ
@@ -53,28 +68,44 @@ class Accumulator {
    * @return 直近 index 番目のデータ
    */
   const T& operator[](const std::size_t index) const {
-    return buffer[(S + head - index) % S];
+    return buffer[wrap(S + head - index)];
   }
   /**
    * @brief 直近 n 個の平均を取得する関数
+   * @details n == S のときは O(1)、それ以外は O(n)
    * @param[in] n 平均個数
    * @return 平均値
    */
   const T average(const int n = S) const {
+    if (n == static_cast<int>(S)) return sum_ / n;
     T sum = T();
-    for (int i = 0; i < n; i++) {
-      sum += buffer[(S + head - i) % S];
-    }
+    for (int i = 0; i < n; i++) sum += (*this)[i];
     return sum / n;
   }
+  /**
+   * @brief バッファ全体の和を返す関数
+   */
+  const T& sum() const { return sum_; }
   /**
    * @brief リングバッファのサイズを返す関数
    */
   std::size_t size() const { return S; }
 
  private:
-  T* buffer; /**< @brief リングバッファとして使う配列のポインタ */
-  std::size_t head; /**< @brief リングバッファの先頭インデックス */
+  std::array<T, S> buffer; /**< @brief リングバッファとして使う配列 */
+  std::size_t head;        /**< @brief リングバッファの先頭インデックス */
+  T sum_;                  /**< @brief バッファ全体の和 */
+  T lap_sum;               /**< @brief 今回の周回で追加されたデータの和 */
+
+  /**
+   * @brief 添字をバッファの範囲に収める関数
+   */
+  static constexpr std::size_t wrap(const std::size_t i) {
+    if constexpr ((S & (S - 1)) == 0)
+      return i & (S - 1);
+    else
+      return i % S;
+  }
 };
 
 }  // namespace ctrl
@@ -0,0 +1,212 @@
+/**
+ * @file columnar.h
+ * @brief 軌道の時系列を列ごとに連続した float32 配列として保存する形式
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdio>  //< for std::tmpfile
+#include <cstring>  //< for std::strncpy
+#include <fstream>
+#include <initializer_list>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "state.h"
+
+/**
+ * @brief 制御関係の名前空間
+ */
+namespace ctrl {
+
+/**
+ * @brief 列指向バイナリ形式のファイルヘッダ
+ *
+ * ファイルのレイアウト (リトルエンディアン)
+ * - ColumnarHeader (16 byte)
+ * - 列名 (各 kNameLength byte、ヌル終端またはヌル埋め) × n_columns
+ * - 0 埋めにより kAlignment byte 境界に揃えたあと、
+ *   float32 の列 (各 n_rows 要素) × n_columns
+ *
+ * 各列は連続しているので、ファイルを mmap すればコピーなしで配列として扱える。
+ */
+struct ColumnarHeader {
+  static constexpr uint16_t kVersion = 1; /**< @brief 形式の版 */
+  static constexpr std::size_t kNameLength = 16; /**< @brief 列名の長さ */
+  static constexpr std::size_t kAlignment = 64; /**< @brief データ部の整列 */
+
+  char magic[4] = {'M', 'M', 'C', 'B'}; /**< @brief 識別子 */
+  uint16_t version = kVersion;          /**< @brief 形式の版 */
+  uint16_t n_columns = 0;               /**< @brief 列数 */
+  uint64_t n_rows = 0;                  /**< @brief 行数 */
+
+  /**
+   * @brief ファイル先頭からデータ部までのオフセット [byte]
+   */
+  std::size_t dataOffset() const {
+    const auto end = sizeof(ColumnarHeader) + kNameLength * n_columns;
+    return (end + kAlignment - 1) / kAlignment * kAlignment;
+  }
+};
+static_assert(sizeof(ColumnarHeader) == 16, "ColumnarHeader must be 16 bytes");
+
+/**
+ * @brief 列指向バイナリ形式の書き込み器
+ *
+ * 行単位で値を追加し、最後に列ごとにまとめて書き出す。
+ *
+ * - メモリ上に保持するのは直近の kBlockRows 行のみで、メモリ使用量は
+ *   行数によらず 列数 × kBlockRows × 4 byte で一定である
+ * - 満ちたブロックは一時ファイル (std::tmpfile) に退避し、
+ *   write() のときに列ごとに読み戻して連続した列に並べ替える
+ */
+class ColumnarWriter {
+ public:
+  /**
+   * @brief 曲線加速の列名 (AccelCurve, AccelDesigner 用)
+   */
+  static constexpr std::array<const char*, 5> kAccelColumns = {
+      {"t", "j", "a", "v", "x"}};
+  /**
+   * @brief 時刻と State の全成分の列名
+   */
+  static constexpr std::array<const char*, 13> kStateColumns = {
+      {"t", "q.x", "q.y", "q.th", "dq.x", "dq.y", "dq.th", "ddq.x", "ddq.y",
+       "ddq.th", "dddq.x", "dddq.y", "dddq.th"}};
+  /**
+   * @brief メモリ上に保持するブロックの行数
+   */
+  static constexpr std::size_t kBlockRows = 4096;
+
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param[in] names 列名のリスト、各列名は kNameLength 文字未満であること
+   */
+  explicit ColumnarWriter(std::initializer_list<const char*> names)
+      : names(names.begin(), names.end()), block(names.size() * kBlockRows) {}
+  /**
+   * @brief コンストラクタ
+   * @param[in] names 列名の配列 (kAccelColumns, kStateColumns など)
+   */
+  template <std::size_t N>
+  explicit ColumnarWriter(const std::array<const char*, N>& names)
+      : names(names.begin(), names.end()), block(N * kBlockRows) {}
+  /**
+   * @brief デストラクタ。一時ファイルを削除する。
+   */
+  ~ColumnarWriter() {
+    if (spill) std::fclose(spill);
+  }
+  ColumnarWriter(const ColumnarWriter&) = delete;
+  ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+  /**
+   * @brief 値を1列分追加するオペレータ
+   */
+  ColumnarWriter& operator<<(const float value) {
+    if (column < names.size()) block[column++ * kBlockRows + fill] = value;
+    return *this;
+  }
+  /**
+   * @brief State の全成分を追加する関数 (kStateColumns の時刻以降の順)
+   */
+  ColumnarWriter& operator<<(const State& s) {
+    for (const auto& p : {s.q, s.dq, s.ddq, s.dddq})
+      *this << p.x << p.y << p.th;
+    return *this;
+  }
+  /**
+   * @brief 行を終える関数。不足している列は 0 で埋める。
+   */
+  ColumnarWriter& endRow() {
+    while (column < names.size()) *this << 0.0f;
+    column = 0;
+    ++n_rows;
+    if (++fill == kBlockRows) spillBlock();
+    return *this;
+  }
+  /**
+   * @brief 行数を取得する関数
+   */
+  std::size_t rows() const { return n_rows; }
+  /**
+   * @brief 蓄積したデータを書き出す関数
+   * @param[in] os 出力先 (バイナリモードで開いておくこと)
+   * @return 書き込みに成功したか
+   */
+  bool write(std::ostream& os) const {
+    if (failed) return false;
+    ColumnarHeader header;
+    header.n_columns = names.size();
+    header.n_rows = n_rows;
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& name : names) {
+      char buf[ColumnarHeader::kNameLength] = {};
+      std::strncpy(buf, name.c_str(), sizeof(buf) - 1);
+      os.write(buf, sizeof(buf));
+    }
+    const auto pos =
+        sizeof(header) + ColumnarHeader::kNameLength * names.size();
+    const std::vector<char> padding(header.dataOffset() - pos, 0);
+    os.write(padding.data(), padding.size());
+    /* 退避したブロックから各列の部分を順に読み戻す;
+     * ファイル全体の大きさは long に収まらない場合があるので、
+     * シークはブロック単位の現在位置からの相対位置で行う */
+    const auto n_blocks = n_rows / kBlockRows;
+    const long block_bytes = kBlockRows * sizeof(float);
+    const long skip = static_cast<long>(names.size() - 1) * block_bytes;
+    std::vector<float> buf(n_blocks ? kBlockRows : 0);
+    for (std::size_t c = 0; c < names.size(); ++c) {
+      if (n_blocks) std::rewind(spill);
+      for (std::size_t b = 0; b < n_blocks; ++b) {
+        const auto offset = b == 0 ? static_cast<long>(c) * block_bytes : skip;
+        if (std::fseek(spill, offset, SEEK_CUR) != 0 ||
+            std::fread(buf.data(), sizeof(float), kBlockRows, spill) !=
+                kBlockRows)
+          return false;
+        os.write(reinterpret_cast<const char*>(buf.data()),
+                 kBlockRows * sizeof(float));
+      }
+      os.write(reinterpret_cast<const char*>(block.data() + c * kBlockRows),
+               fill * sizeof(float));
+    }
+    return static_cast<bool>(os);
+  }
+  /**
+   * @brief 蓄積したデータをファイルに書き出す関数
+   * @param[in] filename 出力ファイル名
+   * @return 書き込みに成功したか
+   */
+  bool save(const std::string& filename) const {
+    std::ofstream of(filename, std::ios::binary);
+    return of && write(of);
+  }
+
+ private:
+  std::vector<std::string> names; /**< @brief 列名 */
+  std::vector<float> block;       /**< @brief 直近のブロック (列ごとに連続) */
+  std::size_t fill = 0;           /**< @brief ブロック内の行数 */
+  std::size_t column = 0;         /**< @brief 行内の現在の列番号 */
+  uint64_t n_rows = 0;            /**< @brief 行数 */
+  std::FILE* spill = nullptr;     /**< @brief 満ちたブロックの退避先 */
+  bool failed = false;            /**< @brief 退避に失敗したか */
+
+  /**
+   * @brief 満ちたブロックを一時ファイルの末尾に退避する関数
+   */
+  void spillBlock() {
+    fill = 0;
+    if (!spill) spill = std::tmpfile();
+    if (!spill || std::fseek(spill, 0, SEEK_END) != 0 ||
+        std::fwrite(block.data(), sizeof(float), block.size(), spill) !=
+            block.size())
+      failed = true;
+  }
+};
+
+}  // namespace ctrl
@@ -0,0 +1,212 @@
+/**
+ * @file csv_writer.h
+ * @brief 大きなバッファに数値を書式化してまとめて出力する CSV 書き込み器
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-08
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#pragma once
+
+#include <charconv>  //< for std::to_chars
+#include <cstdint>
+#include <cstdio>  //< for std::snprintf
+#include <initializer_list>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+/* 1 to format floating-point numbers with std::to_chars (shortest form);
+ * 0 to use std::snprintf where it is unavailable, e.g. GCC 10 or earlier */
+#ifndef CTRL_CSV_WRITER_TO_CHARS
+#ifdef __cpp_lib_to_chars
+#define CTRL_CSV_WRITER_TO_CHARS 1
+#else
+#define CTRL_CSV_WRITER_TO_CHARS 0
+#endif
+#endif
+
+/**
+ * @brief 制御関係の名前空間
+ */
+namespace ctrl {
+
+/**
+ * @brief バッファ付きの CSV 書き込み器
+ *
+ * - 数値は std::to_chars により、往復変換可能な最短表現で書式化する
+ *   (CTRL_CSV_WRITER_TO_CHARS が 0 の場合、浮動小数点数は std::snprintf)
+ * - 行ごとのフラッシュは行わず、バッファが満ちたときと破棄時にのみ出力する
+ * - select() により出力する列を選択できる (列番号は 0 始まり、最大 64 列)
+ * - 曲線の軌道は、下記の printCsv(CsvWriter&, ...) により出力できる。
+ *   軌道クラスのメンバ関数 printCsv() は、コアのヘッダをこのヘッダに
+ *   依存させないため、従来どおり std::ostream に直接出力する
+ */
+class CsvWriter {
+ public:
+  /**
+   * @brief バッファサイズのデフォルト値 [byte]
+   */
+  static constexpr std::size_t kBufferSizeDefault = 1 << 16;
+  /**
+   * @brief 選択できる列の数
+   */
+  static constexpr std::size_t kColumnMax = 64;
+
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param[in] os 出力先のストリーム
+   * @param[in] buffer_size 書き込みバッファのサイズ [byte]
+   */
+  explicit CsvWriter(std::ostream& os,
+                     const std::size_t buffer_size = kBufferSizeDefault)
+      : os(os), buffer(buffer_size > kFieldMax ? buffer_size : 2 * kFieldMax) {}
+  /**
+   * @brief デストラクタ。残りのデータを出力する。
+   */
+  ~CsvWriter() { flush(); }
+  CsvWriter(const CsvWriter&) = delete;
+  CsvWriter& operator=(const CsvWriter&) = delete;
+  /**
+   * @brief 出力する列を選択する関数
+   * @details 範囲外の列が含まれていたかは good() で確認できる。
+   * @param[in] columns 出力する列番号のリスト; kColumnMax 以上の列は無視する
+   */
+  CsvWriter& select(std::initializer_list<std::size_t> columns) {
+    mask = 0;
+    selection_valid = true;
+    for (const auto c : columns) {
+      if (c >= kColumnMax) {
+        selection_valid = false;
+        continue;
+      }
+      mask |= uint64_t(1) << c;
+    }
+    return *this;
+  }
+  /**
+   * @brief すべての列を出力するように戻す関数
+   */
+  CsvWriter& selectAll() {
+    mask = ~uint64_t(0);
+    selection_valid = true;
+    return *this;
+  }
+  /**
+   * @brief 直前の列の選択が有効で、出力先のストリームが正常か
+   */
+  bool good() const { return selection_valid && os.good(); }
+  /**
+   * @brief 見出し行を出力する関数
+   * @param[in] names 列名のリスト (選択されていない列は出力されない)
+   */
+  CsvWriter& header(std::initializer_list<const char*> names) {
+    for (const auto name : names) {
+      if (!selected()) continue;
+      separator();
+      for (const char* c = name; *c; ++c) {
+        reserve(1);
+        buffer[fill++] = *c;
+      }
+    }
+    return endRow();
+  }
+  /**
+   * @brief 数値を1列分出力するオペレータ
+   * @tparam T 算術型 (bool を除く)
+   */
+  template <typename T,
+            typename = std::enable_if_t<std::is_arithmetic<T>::value &&
+                                        !std::is_same<T, bool>::value>>
+  CsvWriter& operator<<(const T value) {
+    if (!selected()) return *this;
+    separator();
+    reserve(kFieldMax);
+    fill += format(buffer.data() + fill, value);
+    return *this;
+  }
+  /**
+   * @brief 行を終える関数
+   */
+  CsvWriter& endRow() {
+    reserve(1);
+    buffer[fill++] = '\n';
+    column = 0;
+    row_empty = true;
+    return *this;
+  }
+  /**
+   * @brief バッファの内容をストリームに出力する関数
+   */
+  void flush() {
+    if (fill) os.write(buffer.data(), fill);
+    fill = 0;
+  }
+
+ private:
+  /** @brief 1列の最大文字数 (数値の最短表現は高々 24 文字) */
+  static constexpr std::size_t kFieldMax = 32;
+
+  std::ostream& os;         /**< @brief 出力先 */
+  std::vector<char> buffer; /**< @brief 書き込みバッファ */
+  std::size_t fill = 0;     /**< @brief バッファの使用量 [byte] */
+  uint64_t mask = ~uint64_t(0); /**< @brief 列の選択状態 */
+  std::size_t column = 0;       /**< @brief 行内の現在の列番号 */
+  bool row_empty = true; /**< @brief 現在の行にまだ何も出力していない */
+  bool selection_valid = true; /**< @brief 範囲外の列が選択されていない */
+
+  /** @brief 現在の列が選択されているか判定して、列番号を進める */
+  bool selected() {
+    const auto c = column++;
+    return c < kColumnMax && ((mask >> c) & 1);
+  }
+  /** @brief 数値を書式化して、書き込んだ文字数を返す */
+  template <typename T>
+  static std::size_t format(char* const first, const T value) {
+#if CTRL_CSV_WRITER_TO_CHARS
+    return std::to_chars(first, first + kFieldMax, value).ptr - first;
+#else
+    if constexpr (std::is_floating_point<T>::value) {
+      /* max_digits10 桁あれば元の値に戻せる */
+      const int n = std::snprintf(first, kFieldMax, "%.*Lg",
+                                  std::numeric_limits<T>::max_digits10,
+                                  static_cast<long double>(value));
+      return n > 0 ? static_cast<std::size_t>(n) : 0;
+    } else {
+      return std::to_chars(first, first + kFieldMax, value).ptr - first;
+    }
+#endif
+  }
+  /** @brief 行の2列目以降であれば区切り文字を出力する */
+  void separator() {
+    if (!row_empty) {
+      reserve(1);
+      buffer[fill++] = ',';
+    }
+    row_empty = false;
+  }
+  /** @brief 空き容量が足りなければフラッシュする */
+  void reserve(const std::size_t n) {
+    if (fill + n > buffer.size()) flush();
+  }
+};
+
+/**
+ * @brief 曲線の軌道を CSV に出力する関数
+ * @details 列は t, j, a, v, x の順。AccelCurve, AccelDesigner および
+ * AccelDesignerFixed に使用できる。
+ * @param[out] csv 出力先
+ * @param[in] curve 曲線
+ * @param[in] t_interval 出力の時間間隔 [s]
+ */
+template <typename Curve>
+void printCsv(CsvWriter& csv, const Curve& curve,
+              const float t_interval = 1e-3f) {
+  for (float t = curve.t_0(); t < curve.t_end(); t += t_interval) {
+    csv << t << curve.j(t) << curve.a(t) << curve.v(t) << curve.x(t);
+    csv.endRow();
+  }
+}
+
+}  // namespace ctrl
@@ -0,0 +1,272 @@
+/**
+ * @file library.h
+ * @brief スラローム形状や走行パラメータの表を固定レイアウトのバイナリで共有する形式
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>  //< for std::memcmp
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#include "accel_profile.h"
+#include "slalom/slalom.h"
+
+/**
+ * @brief 制御関係の名前空間
+ */
+namespace ctrl {
+
+/**
+ * @brief CRC-32 (IEEE 802.3, 反転多項式 0xEDB88320) を計算する関数
+ *
+ * @param[in] data データ
+ * @param[in] size データの長さ [byte]
+ * @param[in] crc 前回までの値; 分割して計算する場合に与える
+ * @return CRC-32
+ */
+inline uint32_t crc32(const void* data, const std::size_t size,
+                      uint32_t crc = 0) {
+  struct Table {
+    std::array<uint32_t, 256> t{};
+    constexpr Table() {
+      for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k)
+          c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        t[i] = c;
+      }
+    }
+  };
+  static constexpr Table table;
+  const auto* p = static_cast<const uint8_t*>(data);
+  crc = ~crc;
+  for (std::size_t i = 0; i < size; ++i)
+    crc = table.t[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+/**
+ * @brief ライブラリの要素の種類
+ */
+enum class LibraryType : uint16_t {
+  Shape = 1,          /**< @brief slalom::Shape */
+  AccelProfile = 2,   /**< @brief AccelProfile */
+  AccelProfile16 = 3, /**< @brief AccelProfile16 */
+};
+
+/**
+ * @brief 要素の型から LibraryType を得るための特性
+ */
+template <typename T>
+struct LibraryTraits;
+/** @brief slalom::Shape の特性 */
+template <>
+struct LibraryTraits<slalom::Shape> {
+  static constexpr LibraryType type = LibraryType::Shape;
+};
+/** @brief AccelProfile の特性 */
+template <>
+struct LibraryTraits<AccelProfile> {
+  static constexpr LibraryType type = LibraryType::AccelProfile;
+};
+/** @brief AccelProfile16 の特性 */
+template <>
+struct LibraryTraits<AccelProfile16> {
+  static constexpr LibraryType type = LibraryType::AccelProfile16;
+};
+
+/**
+ * @brief 表全体で共有するパラメータ
+ *
+ * 使用しない値は 0 とする。
+ */
+struct LibraryParams {
+  float j_max = 0;  /**< @brief 最大躍度 (AccelProfile, AccelProfile16) */
+  float a_max = 0;  /**< @brief 最大加速度 (AccelProfile, AccelProfile16) */
+  float v_unit = 0; /**< @brief 速度の単位 (AccelProfile16) */
+  float x_unit = 0; /**< @brief 距離の単位 (AccelProfile16) */
+
+  /**
+   * @brief AccelProfile16 の量子化の単位
+   */
+  AccelProfileScale scale() const { return {v_unit, x_unit}; }
+};
+
+/**
+ * @brief ライブラリ形式のヘッダ
+ *
+ * ファイルのレイアウト (リトルエンディアン)
+ * - LibraryHeader (36 byte)
+ * - 要素 (各 entry_size byte) × n_entries
+ *
+ * - 要素は構造体のメモリ表現そのままなので、
+ *   ファイルを mmap するか、フラッシュの読み出し専用領域に配置すれば、
+ *   コピーや解析なしで LibraryView により参照できる
+ * - 先頭は 4 byte 境界に揃えて配置すること
+ * - crc は、crc を 0 としたヘッダと要素全体の CRC-32
+ * - 要素の型のレイアウトを変更した場合は kVersion を更新すること
+ */
+struct LibraryHeader {
+  static constexpr uint16_t kVersion = 1; /**< @brief 形式の版 */
+
+  char magic[4] = {'M', 'M', 'L', 'B'}; /**< @brief 識別子 */
+  uint16_t version = kVersion;          /**< @brief 形式の版 */
+  LibraryType type = LibraryType::Shape; /**< @brief 要素の種類 */
+  uint16_t entry_size = 0;              /**< @brief 要素の長さ [byte] */
+  uint16_t reserved = 0;                /**< @brief 予約 (0 とする) */
+  uint32_t n_entries = 0;               /**< @brief 要素数 */
+  uint32_t crc = 0;                     /**< @brief CRC-32 */
+  LibraryParams params;                 /**< @brief 共有パラメータ */
+
+  /**
+   * @brief ヘッダを含むライブラリ全体の長さ [byte]
+   */
+  std::size_t totalSize() const {
+    return sizeof(LibraryHeader) + std::size_t(entry_size) * n_entries;
+  }
+  /**
+   * @brief crc を 0 としたヘッダと要素全体の CRC-32 を計算する関数
+   * @param[in] entries 要素の先頭
+   */
+  uint32_t computeCrc(const void* entries) const {
+    LibraryHeader h = *this;
+    h.crc = 0;
+    const auto crc = crc32(&h, sizeof(h));
+    return crc32(entries, std::size_t(entry_size) * n_entries, crc);
+  }
+};
+static_assert(sizeof(LibraryHeader) == 36, "LibraryHeader must be 36 bytes");
+static_assert(sizeof(slalom::Shape) == 12 * 4,
+              "slalom::Shape must be packed without padding");
+static_assert(std::is_trivially_copyable<slalom::Shape>::value,
+              "slalom::Shape must be trivially copyable");
+static_assert(sizeof(AccelProfile) == 16, "AccelProfile must be 16 bytes");
+static_assert(sizeof(AccelProfile16) == 8, "AccelProfile16 must be 8 bytes");
+
+/**
+ * @brief ライブラリを書き出す関数
+ *
+ * @param[out] os 出力先 (バイナリモードで開いておくこと)
+ * @param[in] entries 要素の配列
+ * @param[in] n 要素数
+ * @param[in] params 共有パラメータ
+ * @return 書き込みに成功したか
+ */
+template <typename T>
+bool writeLibrary(std::ostream& os, const T* entries, const std::size_t n,
+                  const LibraryParams& params = {}) {
+  LibraryHeader header;
+  header.type = LibraryTraits<T>::type;
+  header.entry_size = sizeof(T);
+  header.n_entries = n;
+  header.params = params;
+  header.crc = header.computeCrc(entries);
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  os.write(reinterpret_cast<const char*>(entries), sizeof(T) * n);
+  return static_cast<bool>(os);
+}
+/**
+ * @brief ライブラリをファイルに書き出す関数
+ *
+ * @param[in] filename 出力ファイル名
+ * @param[in] entries 要素の配列
+ * @param[in] n 要素数
+ * @param[in] params 共有パラメータ
+ * @return 書き込みに成功したか
+ */
+template <typename T>
+bool saveLibrary(const std::string& filename, const T* entries,
+                 const std::size_t n, const LibraryParams& params = {}) {
+  std::ofstream of(filename, std::ios::binary);
+  return of && writeLibrary(of, entries, n, params);
+}
+
+/**
+ * @brief ライブラリをコピーなしで参照するビュー
+ *
+ * - 構築は O(1) で、ヘッダの整合性のみを確認する
+ * - CRC の確認は O(n) なので、必要なときに verify() で行う
+ * - 参照先のメモリはビューより長く生存すること
+ *
+ * @code
+ * const LibraryView<slalom::Shape> shapes(data, size);
+ * if (!shapes.valid() || !shapes.verify()) return;
+ * slalom::Trajectory st(shapes[0]);
+ * @endcode
+ * @tparam T 要素の型
+ */
+template <typename T>
+class LibraryView {
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param[in] data ライブラリの先頭 (mmap の領域やフラッシュ上の配列など)
+   * @param[in] size 参照可能な長さ [byte]
+   */
+  LibraryView(const void* data, const std::size_t size)
+      : data(static_cast<const uint8_t*>(data)) {
+    if (size < sizeof(LibraryHeader)) return;
+    if (reinterpret_cast<uintptr_t>(data) % alignof(LibraryHeader)) return;
+    const auto& h = header();
+    if (std::memcmp(h.magic, LibraryHeader().magic, sizeof(h.magic))) return;
+    if (h.version != LibraryHeader::kVersion) return;
+    if (h.type != LibraryTraits<T>::type || h.entry_size != sizeof(T)) return;
+    if (h.totalSize() > size) return;
+    n = h.n_entries;
+    ok = true;
+  }
+  /**
+   * @brief ヘッダが整合しているか
+   */
+  bool valid() const { return ok; }
+  /**
+   * @brief CRC が一致するかを確認する関数
+   */
+  bool verify() const {
+    return valid() && header().computeCrc(begin()) == header().crc;
+  }
+  /**
+   * @brief ヘッダ
+   * @attention valid() でない場合は参照しないこと
+   */
+  const LibraryHeader& header() const {
+    return *reinterpret_cast<const LibraryHeader*>(data);
+  }
+  /**
+   * @brief 共有パラメータ
+   */
+  const LibraryParams& params() const { return header().params; }
+  /**
+   * @brief 要素数; valid() でない場合は 0
+   */
+  std::size_t size() const { return n; }
+  /**
+   * @brief 要素の先頭
+   */
+  const T* begin() const {
+    return reinterpret_cast<const T*>(data + sizeof(LibraryHeader));
+  }
+  /**
+   * @brief 要素の終端
+   */
+  const T* end() const { return begin() + n; }
+  /**
+   * @brief 要素の参照
+   */
+  const T& operator[](const std::size_t i) const { return begin()[i]; }
+
+ private:
+  const uint8_t* data; /**< @brief ライブラリの先頭 */
+  std::size_t n = 0;   /**< @brief 有効な要素数 */
+  bool ok = false;     /**< @brief ヘッダが整合しているか */
+};
+
+}  // namespace ctrl
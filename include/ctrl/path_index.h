@@ -0,0 +1,177 @@
+/**
+ * @file path_index.h
+ * @brief 動作列の位置姿勢を累積して保持し、高速に参照する索引を定義
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#pragma once
+
+#include <algorithm>  //< for std::upper_bound
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>  //< for std::numeric_limits
+
+#include "accel_designer.h"
+#include "pose.h"
+#include "rotation.h"
+#include "slalom/slalom.h"
+
+/**
+ * @brief 制御関係の名前空間
+ */
+namespace ctrl {
+
+/**
+ * @brief 動作列の累積位置姿勢の索引
+ *
+ * 直線やスラロームの動作列について、各動作の始点の位置姿勢 (SE(2) の累積)
+ * と累積走行距離を保持する。
+ *
+ * - i 番目の動作の後の位置姿勢は O(1) で得られる
+ * - 走行距離からの位置姿勢は二分探索により O(log n) で得られる
+ * - 末尾への追加と、途中以降の削除 (再計画) は O(1)
+ * - 固定長の配列であり、ヒープを使用しない
+ *
+ * 動作の途中の位置姿勢は、一定曲率の円弧で補間する。
+ * 直線と円弧では厳密であり、スラロームでは終点で一致する近似となる。
+ * スラロームの厳密な軌道が必要な場合は slalom::Trajectory を使用すること。
+ *
+ * @tparam N 動作の最大数
+ */
+template <std::size_t N>
+class PathIndex {
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param[in] start 始点の位置姿勢
+   */
+  PathIndex(const Pose& start = {}) { clear(start); }
+  /**
+   * @brief 動作列を空にする関数
+   * @param[in] start 始点の位置姿勢
+   */
+  void clear(const Pose& start = {}) {
+    n = 0;
+    poses[0] = start;
+    rotations[0] = Rotation(start.th);
+    distances[0] = 0;
+  }
+  /**
+   * @brief 末尾に動作を追加する関数
+   * @param[in] move 動作の始点から見た終点の位置姿勢
+   * @param[in] length 動作の走行距離
+   * @return 追加できたか (容量が足りない場合は false)
+   */
+  bool push(const Pose& move, const float length) {
+    if (n >= N) return false;
+    /* 円弧で補間したときの終点の差を、補間の補正量として保持する */
+    const auto arc_end = Pose().arc(length, move.th);
+    moves[n] = {move.th, length, move.x - arc_end.x, move.y - arc_end.y};
+    poses[n + 1] = poses[n] + move.rotate(rotations[n]);
+    rotations[n + 1] = Rotation(poses[n + 1].th);
+    distances[n + 1] = distances[n] + length;
+    ++n;
+    return true;
+  }
+  /**
+   * @brief 末尾に直線を追加する関数
+   * @param[in] distance 走行距離
+   */
+  bool pushStraight(const float distance) {
+    return push(Pose(distance, 0, 0), distance);
+  }
+  /**
+   * @brief 末尾にスラロームを追加する関数
+   * @param[in] shape スラローム形状
+   */
+  bool pushSlalom(const slalom::Shape& shape) {
+    return push(shape.total, slalomLength(shape));
+  }
+  /**
+   * @brief 先頭の n 個の動作を残して、以降を削除する関数
+   * @details 途中から再計画する場合に使用する
+   */
+  void truncate(const std::size_t size) { n = std::min(n, size); }
+  /**
+   * @brief 動作の数
+   */
+  std::size_t size() const { return n; }
+  /**
+   * @brief 動作の最大数
+   */
+  static constexpr std::size_t capacity() { return N; }
+  /**
+   * @brief 全体の走行距離
+   */
+  float length() const { return distances[n]; }
+  /**
+   * @brief i 個の動作の後の位置姿勢; pose(0) が始点
+   * @param[in] i 動作の数 (0 以上 size() 以下)
+   */
+  const Pose& pose(const std::size_t i) const { return poses[i]; }
+  /**
+   * @brief i 個の動作の後の累積走行距離
+   * @param[in] i 動作の数 (0 以上 size() 以下)
+   */
+  float distance(const std::size_t i) const { return distances[i]; }
+  /**
+   * @brief 走行距離 s の地点を含む動作の番号
+   * @return [0, size()) の番号; 範囲外の s は両端に丸める
+   */
+  std::size_t indexAt(const float s) const {
+    if (n == 0) return 0;
+    const auto* first = distances.data() + 1;
+    const auto it = std::upper_bound(first, first + n - 1, s);
+    return static_cast<std::size_t>(it - first);
+  }
+  /**
+   * @brief 走行距離 s の地点の位置姿勢
+   * @param[in] s 始点からの走行距離; 範囲外の値は両端に丸める
+   */
+  Pose poseAt(const float s) const {
+    if (n == 0) return poses[0];
+    const auto i = indexAt(s);
+    const auto& m = moves[i];
+    if (!(m.length > 0)) return poses[i + 1];
+    const auto u = std::min(std::max(s - distances[i], 0.0f), m.length);
+    const auto f = u / m.length;
+    /* 円弧で補間し、終点の差を比例配分して端点を一致させる */
+    const auto arc = Pose().arc(u, f * m.th);
+    const Pose local(arc.x + f * m.ex, arc.y + f * m.ey, arc.th);
+    return poses[i] + local.rotate(rotations[i]);
+  }
+  /**
+   * @brief スラロームの走行距離 (前後の直線を含む)
+   * @param[in] shape スラローム形状
+   */
+  static float slalomLength(const slalom::Shape& shape) {
+    /* 姿勢の変化がない場合は直線とする */
+    if (std::abs(shape.total.th) < std::numeric_limits<float>::epsilon())
+      return std::hypot(shape.total.x, shape.total.y);
+    /* 曲線部分は基準速度 v_ref で角速度の曲線加減速を行う */
+    const AccelDesigner ad(shape.dddth_max, shape.ddth_max, shape.dth_max, 0,
+                           0, shape.total.th);
+    return shape.straight_prev + shape.v_ref * ad.t_end() +
+           shape.straight_post;
+  }
+
+ private:
+  /**
+   * @brief 動作
+   */
+  struct Move {
+    float th;     /**< @brief 姿勢の変化量 [rad] */
+    float length; /**< @brief 走行距離 */
+    float ex;     /**< @brief 円弧補間の終点の x 方向の補正量 */
+    float ey;     /**< @brief 円弧補間の終点の y 方向の補正量 */
+  };
+  std::size_t n;                         /**< @brief 動作の数 */
+  std::array<Move, N> moves;             /**< @brief 動作 */
+  std::array<Pose, N + 1> poses;         /**< @brief 累積位置姿勢 */
+  std::array<Rotation, N + 1> rotations; /**< @brief 累積姿勢の回転 */
+  std::array<float, N + 1> distances;    /**< @brief 累積走行距離 */
+};
+
+}  // namespace ctrl
@@ -7,9 +7,14 @@
  */
 #pragma once
 
+#include <algorithm>  //< for std::min
 #include <cmath>
+#include <cstddef>
 #include <ostream>
 
+#include "polar.h"
+#include "rotation.h"
+
 namespace ctrl {
 
 /**
@@ -25,14 +30,121 @@ struct Pose {
       : x(x), y(y), th(th) {}
   void clear() { x = y = th = 0; }
   Pose mirror_x() const { return Pose(x, -y, -th); }
-  Pose rotate(const float angle) const {
-    const float cos_angle = std::cos(angle);
-    const float sin_angle = std::sin(angle);
-    return {x * cos_angle - y * sin_angle, x * sin_angle + y * cos_angle, th};
+  Pose rotate(const float angle) const { return rotate(Rotation(angle)); }
+  /**
+   * @brief 計算済みの回転による回転; 姿勢は変化しない
+   */
+  Pose rotate(const Rotation& r) const {
+    return {x * r.c - y * r.s, x * r.s + y * r.c, th};
   }
   Pose homogeneous(const Pose& offset) const {
     return offset + this->rotate(offset.th);
   }
+  /**
+   * @brief 位置姿勢の配列を一括で座標変換する関数
+   *
+   * out[i] = in[i].homogeneous(offset) と同じ結果を、
+   * 三角関数の計算1回と、要素ごとの積和で求める。
+   * 入力と出力は同じ配列でもよい。
+   *
+   * @param[in] offset 変換先の座標系における、変換元の座標系の位置姿勢
+   * @param[in] in 変換元の座標系における位置姿勢の配列
+   * @param[out] out 変換後の位置姿勢の配列
+   * @param[in] n 要素数
+   */
+  static void transform(const Pose& offset, const Pose* in, Pose* out,
+                        const std::size_t n) {
+    const Rotation r(offset.th);
+    for (std::size_t i = 0; i < n; ++i) out[i] = offset + in[i].rotate(r);
+  }
+  /**
+   * @brief 点の配列を一括で座標変換する関数 (SoA)
+   *
+   * 壁センサの検出点などを、ロボット座標系から迷路座標系へ変換する。
+   * Pose(x[i], y[i]).homogeneous(offset) の位置と同じ結果となる。
+   * 入力と出力は同じ配列でもよい。
+   *
+   * @param[in] offset 変換先の座標系における、変換元の座標系の位置姿勢
+   * @param[in] x,y 変換元の座標系における点の座標の配列
+   * @param[out] out_x,out_y 変換後の座標の配列
+   * @param[in] n 点の数
+   */
+  static void transformPoints(const Pose& offset, const float* x,
+                              const float* y, float* out_x, float* out_y,
+                              const std::size_t n) {
+    Rotation(offset.th).transform(offset.x, offset.y, x, y, out_x, out_y, n);
+  }
+  /**
+   * @brief 円弧に沿って進んだ後の位置姿勢 (SE(2) の指数写像)
+   *
+   * 1周期の間の曲率を一定とみなした厳密な積分であり、
+   * 刻みが大きくてもオイラー法のような誤差は生じない。
+   *
+   * @param[in] ds 移動距離 (左右の車輪の移動量の平均)
+   * @param[in] dth 姿勢の変化量 [rad]
+   */
+  Pose arc(const float ds, const float dth) const {
+    const auto half = dth / 2;
+    const auto l = ds * sinc(half);
+    return {x + l * std::cos(th + half), y + l * std::sin(th + half),
+            th + dth};
+  }
+  /**
+   * @brief 移動量の列を円弧として積分する関数
+   *
+   * arc() を繰り返すのと同じ結果を、周期ごとの三角関数を省いて計算する。
+   * - 姿勢の向き (cos, sin) を保持し、回転を掛けて更新する
+   * - 半角が小さい場合は、sin と cos をテイラー級数で求める
+   * - 回転の累積誤差を防ぐため、一定周期ごとに向きを計算し直す
+   *
+   * @param[in] start 始点の位置姿勢
+   * @param[in] deltas 周期ごとの移動量; tra が移動距離、rot が姿勢の変化量
+   * @param[in] n 周期の数
+   * @param[out] trace 各周期の後の位置姿勢 (長さ n); 不要な場合は nullptr
+   * @return 終点の位置姿勢
+   */
+  static Pose integrate(const Pose& start, const Polar* deltas,
+                        const std::size_t n, Pose* trace = nullptr) {
+    constexpr std::size_t kResync = 64;
+    Pose q = start;
+    for (std::size_t i0 = 0; i0 < n; i0 += kResync) {
+      float c = std::cos(q.th), s = std::sin(q.th);
+      const auto i_end = std::min(n, i0 + kResync);
+      for (std::size_t i = i0; i < i_end; ++i) {
+        const auto half = deltas[i].rot / 2;
+        float ch, sh, k;  //< cos(half), sin(half), sinc(half)
+        if (std::abs(half) < kSeriesThreshold) {
+          const auto hh = half * half;
+          k = 1 - hh * (1.0f / 6);
+          sh = half * k;
+          ch = 1 - hh * 0.5f;
+        } else {
+          ch = std::cos(half), sh = std::sin(half);
+          k = sh / half;
+        }
+        /* 弦の向き th + half に沿って進む */
+        const auto l = deltas[i].tra * k;
+        q.x += l * (c * ch - s * sh);
+        q.y += l * (s * ch + c * sh);
+        q.th += deltas[i].rot;
+        /* 次の向き th + dth; 倍角の回転を1回掛ける */
+        const auto cd = 1 - 2 * sh * sh, sd = 2 * sh * ch;
+        const auto c_next = c * cd - s * sd;
+        s = s * cd + c * sd;
+        c = c_next;
+        if (trace) trace[i] = q;
+      }
+    }
+    return q;
+  }
+  /**
+   * @brief sinc(x) := sin(x) / x; 小さい x ではテイラー級数で求める
+   */
+  static float sinc(const float x) {
+    if (std::abs(x) >= kSeriesThreshold) return std::sin(x) / x;
+    const auto xx = x * x;
+    return 1 - xx * (1.0f / 6) * (1 - xx * (1.0f / 20));
+  }
   Pose& operator+=(const Pose& o) {
     return x += o.x, y += o.y, th += o.th, *this;
   }
@@ -44,6 +156,13 @@ struct Pose {
   friend std::ostream& operator<<(std::ostream& os, const Pose& o) {
     return os << "(" << o.x << ", " << o.y << ", " << o.th << ")";
   }
+
+ private:
+  /**
+   * @brief テイラー級数を用いる角度の閾値 [rad]
+   * @details 2項で打ち切っても、誤差は float の丸め誤差 (約 6e-8) 未満となる
+   */
+  static constexpr float kSeriesThreshold = 0.02f;
 };
 
 }  // namespace ctrl
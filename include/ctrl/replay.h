@@ -0,0 +1,103 @@
+/**
+ * @file replay.h
+ * @brief 記録されたテレメトリを制御器に再入力して出力を再計算する
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#pragma once
+
+#include <cstddef>
+
+#include "feedback_controller.h"
+#include "telemetry.h"
+#include "trajectory_tracker.h"
+
+/**
+ * @brief 制御関係の名前空間
+ */
+namespace ctrl {
+
+/**
+ * @brief テレメトリの再生器
+ *
+ * 記録された推定値 (est_q, est_v, est_a) と目標状態を、
+ * ゲインを変更した TrajectoryTracker と FeedbackController に
+ * 1周期ずつ入力して、制御入力を再計算する。
+ */
+class Replayer {
+ public:
+  /**
+   * @brief 再生に使用するゲインの組
+   */
+  struct Variant {
+    TrajectoryTracker::Gain tracker_gain; /**< @brief 軌道追従ゲイン */
+    FeedbackController<Polar>::Model model; /**< @brief フィードフォワード */
+    FeedbackController<Polar>::Gain gain;   /**< @brief フィードバック */
+  };
+  /**
+   * @brief 1周期分の再計算結果
+   */
+  struct Output {
+    TrajectoryTracker::Result tracker;        /**< @brief 軌道追従器の出力 */
+    FeedbackController<Polar>::Breakdown bd; /**< @brief 制御入力の内訳 */
+  };
+
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param[in] variant 再生に使用するゲインの組
+   * @param[in] Ts 記録時の制御周期 [s] (間引き前)
+   */
+  Replayer(const Variant& variant,
+           const float Ts = TrajectoryTracker::kIntegrationPeriodDefault)
+      : tt(variant.tracker_gain),
+        fc(variant.model, variant.gain),
+        Ts(Ts) {}
+  /**
+   * @brief 状態の初期化
+   * @param[in] first 再生する最初のレコード
+   */
+  void reset(const TelemetryRecord& first) {
+    tt.reset(first.est_v.tra);
+    fc.reset();
+    tick = first.tick;
+  }
+  /**
+   * @brief 1レコード分を再計算する関数
+   * @details 間引きされたログでは、tick の差分を積分周期とする。
+   * @param[in] r 記録されたレコード
+   * @return 再計算結果
+   */
+  const Output& step(const TelemetryRecord& r) {
+    const auto dt = Ts * (r.tick > tick ? r.tick - tick : 1);
+    tick = r.tick;
+    out.tracker = tt.update(r.est_q, r.est_v, r.est_a, r.ref, dt);
+    fc.update({out.tracker.v, out.tracker.w}, r.est_v,
+              {out.tracker.dv, out.tracker.dw}, r.est_a, dt);
+    out.bd = fc.getBreakdown();
+    return out;
+  }
+  /**
+   * @brief 記録されたレコード列をすべて再生する関数
+   * @tparam F 出力を受け取る関数 f(const TelemetryRecord&, const Output&)
+   * @param[in] records レコード列の先頭
+   * @param[in] n レコード数
+   * @param[in] f 1周期ごとに呼ばれる関数
+   */
+  template <typename F>
+  void run(const TelemetryRecord* records, const std::size_t n, F&& f) {
+    if (n == 0) return;
+    reset(records[0]);
+    for (std::size_t i = 0; i < n; ++i) f(records[i], step(records[i]));
+  }
+
+ protected:
+  TrajectoryTracker tt;          /**< @brief 軌道追従器 */
+  FeedbackController<Polar> fc;  /**< @brief フィードバック制御器 */
+  float Ts;                      /**< @brief 記録時の制御周期 [s] */
+  uint32_t tick = 0;             /**< @brief 直前のレコードの tick */
+  Output out;                    /**< @brief 直近の再計算結果 */
+};
+
+}  // namespace ctrl
@@ -0,0 +1,106 @@
+/**
+ * @file rotation.h
+ * @brief 平面上の回転を cos と sin の組で保持するクラスを定義
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+/**
+ * @brief 制御関係の名前空間
+ */
+namespace ctrl {
+
+/**
+ * @brief 平面上の回転
+ *
+ * - 構築時に cos と sin を1度だけ計算し、以降の回転は積和のみで行う
+ * - 同じ角度で多数の点を回転する場合は、Rotation を使い回すこと
+ */
+struct Rotation {
+  float c; /**< @brief cos(angle) */
+  float s; /**< @brief sin(angle) */
+
+ public:
+  /**
+   * @brief 恒等回転
+   */
+  constexpr Rotation() : c(1), s(0) {}
+  /**
+   * @brief 角度から構築するコンストラクタ
+   * @param[in] angle 回転角 [rad]
+   */
+  explicit Rotation(const float angle)
+      : c(std::cos(angle)), s(std::sin(angle)) {}
+  /**
+   * @brief cos と sin から構築するコンストラクタ
+   */
+  constexpr Rotation(const float c, const float s) : c(c), s(s) {}
+  /**
+   * @brief 逆回転
+   */
+  constexpr Rotation inverse() const { return {c, -s}; }
+  /**
+   * @brief 回転の合成; this の後に o を回転する場合は o * this
+   */
+  constexpr Rotation operator*(const Rotation& o) const {
+    return {c * o.c - s * o.s, s * o.c + c * o.s};
+  }
+  /**
+   * @brief 回転角 [rad]
+   */
+  float angle() const { return std::atan2(s, c); }
+  /**
+   * @brief 点の配列を回転して平行移動する関数 (SoA)
+   *
+   * out = (tx, ty) + R * in を計算する。
+   * 固定長のブロックごとに一時配列を経由するので、
+   * 入出力の重なりの確認なしにコンパイラが SIMD 命令に変換できる。
+   * 入力と出力は同じ配列でもよい。
+   *
+   * @param[in] tx,ty 平行移動量
+   * @param[in] x,y 点の座標の配列
+   * @param[out] out_x,out_y 変換後の座標の配列
+   * @param[in] n 点の数
+   */
+  void transform(const float tx, const float ty, const float* x,
+                 const float* y, float* out_x, float* out_y,
+                 const std::size_t n) const {
+    const std::size_t m = n / kBlock * kBlock;
+    for (std::size_t i0 = 0; i0 < m; i0 += kBlock) {
+      std::array<float, kBlock> bx, by;
+      for (std::size_t k = 0; k < kBlock; ++k) {
+        bx[k] = tx + (c * x[i0 + k] - s * y[i0 + k]);
+        by[k] = ty + (s * x[i0 + k] + c * y[i0 + k]);
+      }
+      for (std::size_t k = 0; k < kBlock; ++k)
+        out_x[i0 + k] = bx[k], out_y[i0 + k] = by[k];
+    }
+    for (std::size_t i = m; i < n; ++i) {
+      const auto xi = x[i], yi = y[i];
+      out_x[i] = tx + (c * xi - s * yi);
+      out_y[i] = ty + (s * xi + c * yi);
+    }
+  }
+  /**
+   * @brief 点の配列を回転する関数 (SoA)
+   * @details 入力と出力は同じ配列でもよい
+   */
+  void rotate(const float* x, const float* y, float* out_x, float* out_y,
+              const std::size_t n) const {
+    transform(0, 0, x, y, out_x, out_y, n);
+  }
+
+ public:
+  /**
+   * @brief 一括変換のブロックの大きさ
+   */
+  static constexpr std::size_t kBlock = 8;
+};
+
+}  // namespace ctrl
@@ -0,0 +1,320 @@
+/**
+ * @file sample_range.h
+ * @brief 軌道を一定周期で遅延評価する範囲 (range) の定義
+ * @details 軌道クラスのヘッダからは読み込まないので、使用する場合に読み込むこと
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+
+#include "accel_designer.h"
+#include "slalom/trajectory.h"
+#include "state.h"
+#include "straight/trajectory.h"
+
+/**
+ * @brief 制御関係の名前空間
+ */
+namespace ctrl {
+
+/**
+ * @brief 時刻つきの躍度、加速度、速度、位置
+ */
+struct AccelSample {
+  float t; /**< @brief 時刻 [s] */
+  float j; /**< @brief 躍度 */
+  float a; /**< @brief 加速度 */
+  float v; /**< @brief 速度 */
+  float x; /**< @brief 位置 */
+};
+
+/**
+ * @brief 時刻つきの状態
+ */
+struct StateSample {
+  float t;     /**< @brief 時刻 [s] */
+  State state; /**< @brief 状態 */
+};
+
+/**
+ * @brief 周期数を整数で数えて、各時刻の値を順に計算するステッパ
+ *
+ * 時刻は t_start + tick * Ts で算出するので、浮動小数点の加算による誤差が累積しない。
+ * ステッパは以下の関数をもつ。
+ * - `bool done() const`: 終端に達したか
+ * - `const value_type& value() const`: 現在の値
+ * - `void next()`: 次の値に進める
+ *
+ * @tparam T 値の型
+ * @tparam F 値の更新関数 f(T& value, std::size_t tick, float t)。
+ * value には直前の値が入っているので、積分による更新もできる。
+ */
+template <typename T, typename F>
+class TickStepper {
+ public:
+  using value_type = T; /**< @brief 値の型 */
+
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param[in] f 値の更新関数
+   * @param[in] t_start 開始時刻 [s]
+   * @param[in] Ts 周期 [s]
+   * @param[in] n 値の個数
+   */
+  TickStepper(const F& f, const float t_start, const float Ts,
+              const std::size_t n)
+      : f(f), t_start(t_start), Ts(Ts), n(n) {
+    if (n > 0) this->f(v, 0, t_start);
+  }
+  bool done() const { return tick >= n; }
+  const value_type& value() const { return v; }
+  void next() {
+    if (++tick < n) f(v, tick, t_start + static_cast<float>(tick) * Ts);
+  }
+
+ private:
+  F f;                 /**< @brief 値の更新関数 */
+  float t_start;       /**< @brief 開始時刻 [s] */
+  float Ts;            /**< @brief 周期 [s] */
+  std::size_t n;       /**< @brief 値の個数 */
+  std::size_t tick = 0; /**< @brief 現在の周期数 */
+  value_type v{};      /**< @brief 現在の値 */
+};
+
+/**
+ * @brief k 個に 1 個の値を取り出すステッパ
+ */
+template <typename S>
+class DecimateStepper {
+ public:
+  using value_type = typename S::value_type; /**< @brief 値の型 */
+
+ public:
+  DecimateStepper(const S& s, const std::size_t k) : s(s), k(k > 0 ? k : 1) {}
+  bool done() const { return s.done(); }
+  const value_type& value() const { return s.value(); }
+  void next() {
+    for (std::size_t i = 0; i < k && !s.done(); ++i) s.next();
+  }
+
+ private:
+  S s;           /**< @brief 元のステッパ */
+  std::size_t k; /**< @brief 間引きの間隔 */
+};
+
+/**
+ * @brief 述語を満たす値のみを取り出すステッパ
+ */
+template <typename S, typename P>
+class FilterStepper {
+ public:
+  using value_type = typename S::value_type; /**< @brief 値の型 */
+
+ public:
+  FilterStepper(const S& s, const P& p) : s(s), p(p) { skip(); }
+  bool done() const { return s.done(); }
+  const value_type& value() const { return s.value(); }
+  void next() {
+    s.next();
+    skip();
+  }
+
+ private:
+  S s; /**< @brief 元のステッパ */
+  P p; /**< @brief 述語 */
+
+  void skip() {
+    while (!s.done() && !p(s.value())) s.next();
+  }
+};
+
+/**
+ * @brief 値を遅延評価する範囲
+ *
+ * 範囲 for 文で使用でき、値は反復のたびに計算されるので、
+ * 系列の長さによらずメモリ使用量は一定である。
+ * 元の軌道オブジェクトを参照するので、範囲は軌道より長く生存してはならない。
+ *
+ * @code
+ * for (const auto& s : samples(trajectory, 1e-3f).decimate(10)) {
+ *   csv << s.t << s.state.q.x, csv.endRow();
+ * }
+ * @endcode
+ * @tparam S ステッパ
+ */
+template <typename S>
+class SampleRange {
+ public:
+  using value_type = typename S::value_type; /**< @brief 値の型 */
+  /**
+   * @brief 終端を表す番兵
+   */
+  struct Sentinel {};
+  /**
+   * @brief 入力イテレータ
+   */
+  class Iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = typename S::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+   public:
+    explicit Iterator(const S& s) : s(s) {}
+    reference operator*() const { return s.value(); }
+    pointer operator->() const { return &s.value(); }
+    Iterator& operator++() {
+      s.next();
+      return *this;
+    }
+    bool operator==(Sentinel) const { return s.done(); }
+    bool operator!=(Sentinel) const { return !s.done(); }
+
+   private:
+    S s; /**< @brief 現在位置のステッパ */
+  };
+
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param[in] s 先頭位置のステッパ
+   */
+  explicit SampleRange(const S& s) : s(s) {}
+  Iterator begin() const { return Iterator(s); }
+  Sentinel end() const { return {}; }
+  /**
+   * @brief k 個に 1 個の値を取り出す範囲を返す関数
+   * @param[in] k 間引きの間隔
+   */
+  SampleRange<DecimateStepper<S>> decimate(const std::size_t k) const {
+    return SampleRange<DecimateStepper<S>>(DecimateStepper<S>(s, k));
+  }
+  /**
+   * @brief 述語 p(value) を満たす値のみを取り出す範囲を返す関数
+   * @param[in] p 述語
+   */
+  template <typename P>
+  SampleRange<FilterStepper<S, P>> filter(const P& p) const {
+    return SampleRange<FilterStepper<S, P>>(FilterStepper<S, P>(s, p));
+  }
+
+ private:
+  S s; /**< @brief 先頭位置のステッパ */
+};
+
+/**
+ * @brief 一定周期の範囲を生成する関数
+ * @param[in] f 値の更新関数 f(T& value, std::size_t tick, float t)
+ * @param[in] t_start 開始時刻 [s]
+ * @param[in] t_end 終了時刻 [s] (この時刻を含む)
+ * @param[in] Ts 周期 [s]
+ */
+template <typename T, typename F>
+SampleRange<TickStepper<T, F>> makeSampleRange(const F& f, const float t_start,
+                                               const float t_end,
+                                               const float Ts) {
+  /* 終了時刻が周期の整数倍のとき、丸め誤差で終点が欠けないようにする */
+  const auto n = t_end < t_start || !(Ts > 0)
+                     ? 0
+                     : static_cast<std::size_t>(
+                           std::floor((t_end - t_start) / Ts + 1e-3f)) + 1;
+  return SampleRange<TickStepper<T, F>>(TickStepper<T, F>(f, t_start, Ts, n));
+}
+
+/**
+ * @brief 一定周期の値を遅延評価する範囲を返す関数
+ * @details 範囲は ad を参照する。
+ * @param[in] ad 曲線加減速の軌道
+ * @param[in] Ts 周期 [s]
+ * @param[in] t_start 開始時刻 [s]
+ * @param[in] t_end 終了時刻 [s] (この時刻を含む)
+ */
+inline auto samples(const BasicAccelDesigner& ad, const float Ts,
+                    const float t_start, const float t_end) {
+  return makeSampleRange<AccelSample>(
+      [&ad](AccelSample& s, std::size_t, const float t) {
+        s = {t, ad.j(t), ad.a(t), ad.v(t), ad.x(t)};
+      },
+      t_start, t_end, Ts);
+}
+/**
+ * @brief 始点から終点までの一定周期の値を遅延評価する範囲を返す関数
+ * @param[in] ad 曲線加減速の軌道
+ * @param[in] Ts 周期 [s]
+ */
+inline auto samples(const BasicAccelDesigner& ad, const float Ts) {
+  return samples(ad, Ts, ad.t_0(), ad.t_end());
+}
+
+/**
+ * @brief 一定周期の状態を遅延評価する範囲を返す関数
+ * @details 範囲は trajectory を参照する。
+ * @param[in] trajectory 直線の軌道
+ * @param[in] Ts 周期 [s]
+ * @param[in] t_start 開始時刻 [s]
+ * @param[in] t_end 終了時刻 [s] (この時刻を含む)
+ */
+template <typename D>
+auto samples(const straight::BasicTrajectory<D>& trajectory, const float Ts,
+             const float t_start, const float t_end) {
+  return makeSampleRange<StateSample>(
+      [&trajectory](StateSample& s, std::size_t, const float t) {
+        s.t = t;
+        trajectory.update(s.state, t);
+      },
+      t_start, t_end, Ts);
+}
+/**
+ * @brief 始点から終点までの一定周期の状態を遅延評価する範囲を返す関数
+ * @param[in] trajectory 直線の軌道
+ * @param[in] Ts 周期 [s]
+ */
+template <typename D>
+auto samples(const straight::BasicTrajectory<D>& trajectory, const float Ts) {
+  return samples(trajectory, Ts, trajectory.t_0(), trajectory.t_end());
+}
+
+/**
+ * @brief 一定周期で軌道を積分した状態を遅延評価する範囲を返す関数
+ *
+ * @details 最初の状態は時刻 t_start における原点の状態で、
+ * 以降は周期 Ts ごとに update() で積分した状態である。
+ * 範囲は trajectory を参照する。
+ * @param[in] trajectory スラロームの軌道
+ * @param[in] Ts 積分時間 [s]
+ * @param[in] t_start 開始時刻 [s]
+ * @param[in] t_end 終了時刻 [s] (この時刻を含む)
+ * @param[in] k_slip スリップ角の比例定数
+ */
+inline auto samples(const slalom::Trajectory& trajectory, const float Ts,
+                    const float t_start, const float t_end,
+                    const float k_slip = 0) {
+  return makeSampleRange<StateSample>(
+      [&trajectory, Ts, k_slip](StateSample& s, const std::size_t tick,
+                                const float t) {
+        /* 最初は積分時間 0 として時刻 t の微分値のみを設定 */
+        const float dt = tick == 0 ? 0 : Ts;
+        trajectory.update(s.state, t - dt, dt, k_slip);
+        s.t = t;
+      },
+      t_start, t_end, Ts);
+}
+/**
+ * @brief ターンの始点から終点までの状態を遅延評価する範囲を返す関数
+ * @param[in] trajectory スラロームの軌道
+ * @param[in] Ts 積分時間 [s]
+ */
+inline auto samples(const slalom::Trajectory& trajectory, const float Ts) {
+  const auto& ad = trajectory.getAccelDesigner();
+  return samples(trajectory, Ts, ad.t_0(), ad.t_end());
+}
+
+}  // namespace ctrl
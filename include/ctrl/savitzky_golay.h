@@ -0,0 +1,196 @@
+/**
+ * @file savitzky_golay.h
+ * @brief Savitzky-Golay フィルタによる平滑化微分器を定義
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "accumulator.h"
+
+/**
+ * @brief 制御関係の名前空間
+ */
+namespace ctrl {
+
+/**
+ * @brief Savitzky-Golay フィルタの係数をコンパイル時に計算する関数
+ *
+ * 直近 S 個のデータに P 次多項式を最小二乗近似し、
+ * 最新の時刻における D 階微分を求める係数を返す。
+ * 遅れのない推定のため、窓の中央ではなく最新のデータで評価する。
+ *
+ * @tparam S 窓の大きさ
+ * @tparam P 多項式の次数
+ * @tparam D 微分の階数
+ * @return 係数; [i] 番目は直近 i 番目のデータに掛ける。サンプリング周期 1 の値。
+ */
+template <std::size_t S, std::size_t P, std::size_t D>
+constexpr std::array<float, S> savitzkyGolayCoefficients() {
+  static_assert(P < S, "S must be greater than P");
+  static_assert(D <= P, "P must be D or more");
+  constexpr std::size_t M = P + 1;
+  /* 条件数を抑えるため、直近 i 番目のデータの時刻を -i/S とする */
+  const auto time = [](const std::size_t i) { return -double(i) / S; };
+  /* 正規方程式の行列 A^T A と右辺を作る */
+  std::array<std::array<double, M + 1>, M> a{};
+  for (std::size_t r = 0; r < M; ++r) {
+    for (std::size_t c = 0; c < M; ++c) {
+      double sum = 0;
+      for (std::size_t i = 0; i < S; ++i) {
+        double t = 1;
+        for (std::size_t k = 0; k < r + c; ++k) t *= time(i);
+        sum += t;
+      }
+      a[r][c] = sum;
+    }
+    a[r][M] = r == D ? 1 : 0;  //< (A^T A) x = e_D
+  }
+  /* 部分ピボット選択付きの Gauss-Jordan 消去法 */
+  for (std::size_t p = 0; p < M; ++p) {
+    std::size_t pivot = p;
+    for (std::size_t r = p + 1; r < M; ++r)
+      if ((a[r][p] < 0 ? -a[r][p] : a[r][p]) >
+          (a[pivot][p] < 0 ? -a[pivot][p] : a[pivot][p]))
+        pivot = r;
+    for (std::size_t c = 0; c <= M; ++c) {
+      const auto tmp = a[p][c];
+      a[p][c] = a[pivot][c];
+      a[pivot][c] = tmp;
+    }
+    for (std::size_t r = 0; r < M; ++r) {
+      if (r == p) continue;
+      const auto f = a[r][p] / a[p][p];
+      for (std::size_t c = p; c <= M; ++c) a[r][c] -= f * a[p][c];
+    }
+  }
+  /* 係数 h_i = D! / S^D * sum_j x_j (-i/S)^j */
+  double factor = 1;
+  for (std::size_t k = 1; k <= D; ++k) factor *= double(k) / S;
+  std::array<float, S> h{};
+  for (std::size_t i = 0; i < S; ++i) {
+    double sum = 0, t = 1;
+    for (std::size_t j = 0; j < M; ++j) {
+      sum += a[j][M] / a[j][j] * t;
+      t *= time(i);
+    }
+    h[i] = static_cast<float>(factor * sum);
+  }
+  return h;
+}
+
+/**
+ * @brief Savitzky-Golay フィルタによる平滑化微分器
+ *
+ * 速度から加速度を求める場合などに、単純な差分より雑音の少ない
+ * 平滑値、1階微分、2階微分を推定する。
+ *
+ * - 係数はコンパイル時に計算されるので、実行時の多項式近似は不要
+ * - 窓は長さ 2S の配列に二重に書き込むことで常に連続となり、
+ *   各出力は係数との1回の内積で得られる
+ * - 内積は独立な複数の部分和 (レーン) で計算するので、
+ *   -ffast-math なしでもコンパイラが SIMD 命令に変換できる
+ *
+ * @code
+ * SavitzkyGolay<16, 2> sg(1e-3f);
+ * sg.push(v);  // 毎周期
+ * const auto est_a = Polar(sg.d1(), 0);
+ * @endcode
+ *
+ * @tparam S 窓の大きさ
+ * @tparam P 多項式の次数; 2階微分を使う場合は 2 以上
+ */
+template <std::size_t S, std::size_t P = 2>
+class SavitzkyGolay {
+ public:
+  /** @brief 平滑値の係数 (サンプリング周期 1) */
+  static constexpr auto kCoeff0 = savitzkyGolayCoefficients<S, P, 0>();
+  /** @brief 1階微分の係数 (サンプリング周期 1) */
+  static constexpr auto kCoeff1 = savitzkyGolayCoefficients<S, P, 1>();
+
+  /**
+   * @brief コンストラクタ
+   * @param[in] Ts サンプリング周期 [s]
+   * @param[in] value 窓内の全データに代入する初期値
+   */
+  SavitzkyGolay(const float Ts, const float value = 0)
+      : scale1(1 / Ts), scale2(1 / Ts / Ts) {
+    clear(value);
+  }
+  /**
+   * @brief 窓をクリアする関数
+   * @param[in] value 代入する値
+   */
+  void clear(const float value = 0) {
+    buffer.fill(value);
+    head = 0;
+  }
+  /**
+   * @brief 最新のデータを追加する関数
+   */
+  void push(const float value) {
+    head = head == 0 ? S - 1 : head - 1;
+    buffer[head] = buffer[head + S] = value;
+  }
+  /**
+   * @brief 最新の時刻における平滑値
+   */
+  float value() const { return dot(kCoeff0.data(), window()); }
+  /**
+   * @brief 最新の時刻における1階微分 [/s]
+   */
+  float d1() const { return dot(kCoeff1.data(), window()) * scale1; }
+  /**
+   * @brief 最新の時刻における2階微分 [/s/s]
+   */
+  float d2() const {
+    static_assert(P >= 2, "P must be 2 or more for the 2nd derivative");
+    static constexpr auto kCoeff2 = savitzkyGolayCoefficients<S, P, 2>();
+    return dot(kCoeff2.data(), window()) * scale2;
+  }
+  /**
+   * @brief 窓内のデータ
+   * @return 連続した S 個のデータの先頭; [0] 番目が最新のデータ
+   */
+  const float* window() const { return buffer.data() + head; }
+  /**
+   * @brief 既存の Accumulator に係数を適用する関数
+   * @details 添字の計算が要素ごとに必要なので、push() を使う方が速い
+   * @param[in] coeff 係数
+   * @param[in] acc 直近 S 個のデータ
+   * @return 係数との内積 (サンプリング周期 1)
+   */
+  static float apply(const std::array<float, S>& coeff,
+                     const Accumulator<float, S>& acc) {
+    float sum = 0;
+    for (std::size_t i = 0; i < S; ++i) sum += coeff[i] * acc[i];
+    return sum;
+  }
+
+ private:
+  static constexpr std::size_t kLanes = 8; /**< @brief 内積の部分和の数 */
+  std::array<float, 2 * S> buffer;          /**< @brief 二重に書き込む窓 */
+  std::size_t head;                         /**< @brief 最新のデータの添字 */
+  float scale1;                             /**< @brief 1階微分の倍率 1/Ts */
+  float scale2;                             /**< @brief 2階微分の倍率 1/Ts^2 */
+
+  /**
+   * @brief 連続した S 個の内積
+   */
+  static float dot(const float* c, const float* x) {
+    constexpr std::size_t kMain = S / kLanes * kLanes;
+    std::array<float, kLanes> lane{};
+    for (std::size_t i = 0; i < kMain; i += kLanes)
+      for (std::size_t k = 0; k < kLanes; ++k) lane[k] += c[i + k] * x[i + k];
+    float sum = 0;
+    for (const auto l : lane) sum += l;
+    for (std::size_t i = kMain; i < S; ++i) sum += c[i] * x[i];
+    return sum;
+  }
+};
+
+}  // namespace ctrl
@@ -9,6 +9,9 @@
 
 #include <ctrl/slalom/slalom.h>
 
+#include <cmath>
+#include <cstddef>
+
 /**
  * @brief 制御関係の名前空間
  */
@@ -64,6 +67,76 @@ class Trajectory {
               const float k_slip = 0) const {
     return Shape::integrate(ad, state, velocity, t, Ts, k_slip);
   }
+  /**
+   * @brief 一定周期で軌道を積分し、結果を配列に書き込む関数
+   *
+   * @details out[0] は積分時間 0 として時刻 t の微分値のみを設定した初期状態、
+   * out[i] (i >= 1) は時刻 t + (i - 1) * Ts から Ts だけ積分した状態であり、
+   * samples() と同じ時刻の並びとなる。
+   * update() を順に呼ぶのと丸め誤差の範囲で一致する。
+   * 角度 (AccelDesigner) は AccelDesigner::Walker により区間を順にたどって評価し、
+   * 前のステップの終点における評価値を次のステップの始点に再利用するので、
+   * update() に比べて 1 ステップあたりの評価回数が 3 回から 2 回に減る。
+   * 時刻は整数の周期数から算出するので、誤差が累積しない。
+   * @param[inout] s 初期状態、終了時には最後の状態に更新される
+   * @param[in] t 開始時刻 [s]
+   * @param[in] Ts 積分時間 [s]
+   * @param[out] out 時刻 t + i * Ts の状態を格納する長さ n の配列
+   * @param[in] n 要素数
+   * @param[in] k_slip スリップ角の比例定数
+   */
+  void rollout(State& s, const float t, const float Ts, State* out,
+               const std::size_t n, const float k_slip = 0) const {
+    if (n == 0) return;
+    const float v = velocity;
+    const float k = -k_slip * v;
+    /* スリップ角; k_slip == 0 のときは atan を省く (結果は同じ) */
+    const auto slip = [k](const float w) {
+      return std::abs(k) > 0 ? std::atan(k * w) : 0.0f;
+    };
+    AccelDesigner::Walker w(ad);
+    /* 始点の評価 */
+    auto e = w.at(t);
+    float th_slip = slip(e.v);
+    float cos_s = std::cos(e.x + th_slip);
+    float sin_s = std::sin(e.x + th_slip);
+    derive(s, v, cos_s, sin_s, e);
+    out[0] = s;
+    for (std::size_t i = 1; i < n; ++i) {
+      const float tm = t + (static_cast<float>(i) - 0.5f) * Ts;
+      const float te = t + static_cast<float>(i) * Ts;
+      /* 中点の評価 */
+      const auto m = w.at(tm);
+      th_slip = slip(m.v);
+      const float cos_m = std::cos(m.x + th_slip);
+      const float sin_m = std::sin(m.x + th_slip);
+      /* 終点の評価 */
+      e = w.at(te);
+      th_slip = slip(e.v);
+      const float cos_e = std::cos(e.x + th_slip);
+      const float sin_e = std::sin(e.x + th_slip);
+      /* Runge-Kutta Integral */
+      s.q.x += v * Ts * (cos_s + 4 * cos_m + cos_e) / 6;
+      s.q.y += v * Ts * (sin_s + 4 * sin_m + sin_e) / 6;
+      derive(s, v, cos_e, sin_e, e);
+      out[i] = s;
+      /* 終点を次のステップの始点として再利用 */
+      cos_s = cos_e;
+      sin_s = sin_e;
+    }
+  }
+  /**
+   * @brief 軌道の開始時刻から一定周期で軌道を積分し、結果を配列に書き込む関数
+   *
+   * @param[in] Ts 積分時間 [s]
+   * @param[out] out 開始時刻から i * Ts 後の状態を格納する長さ n の配列;
+   * out[0] は原点
+   * @param[in] n 要素数
+   */
+  void rollout(const float Ts, State* out, const std::size_t n) const {
+    State s;
+    rollout(s, ad.t_0(), Ts, out, n);
+  }
   /**
    * @brief 並進速度を取得
    */
@@ -82,6 +155,24 @@ class Trajectory {
   const AccelDesigner& getAccelDesigner() const { return ad; }
 
  protected:
+  /**
+   * @brief 位置以外の状態を角度の評価値と並進速度の向きから設定する関数
+   * @details Shape::integrate() の Result と同じ計算
+   */
+  static void derive(State& s, const float v, const float cos_th,
+                     const float sin_th, const AccelDesigner::Walker::Value& e) {
+    s.dq.x = v * cos_th;
+    s.dq.y = v * sin_th;
+    s.q.th = e.x;
+    s.dq.th = e.v;
+    s.ddq.th = e.a;
+    s.dddq.th = e.j;
+    s.ddq.x = -s.dq.y * s.dq.th;
+    s.ddq.y = +s.dq.x * s.dq.th;
+    s.dddq.x = -s.ddq.y * s.dq.th - s.dq.y * s.ddq.th;
+    s.dddq.y = +s.ddq.x * s.dq.th + s.dq.x * s.ddq.th;
+  }
+
   Shape shape;      /**< @brief スラロームの形状 */
   AccelDesigner ad; /**< @brief 角速度用の曲線加速生成器 */
   float velocity;   /**< @brief 並進速度 */
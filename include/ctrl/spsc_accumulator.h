@@ -0,0 +1,142 @@
+/**
+ * @file spsc_accumulator.h
+ * @brief 割り込みからタスクへデータを受け渡すロックフリーの蓄積器を定義
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "accumulator.h"
+
+/**
+ * @brief 制御関係の名前空間
+ */
+namespace ctrl {
+
+/**
+ * @brief SpscAccumulator のリングバッファの既定の長さ
+ * @return 2S 以上の最小の 2 のべき乗
+ */
+constexpr std::size_t spscDefaultLength(const std::size_t S) {
+  std::size_t n = 1;
+  while (n < 2 * S) n *= 2;
+  return n;
+}
+
+/**
+ * @brief 単一生産者・単一消費者 (SPSC) のデータ蓄積器
+ *
+ * センサの割り込み (生産者) が push() し、制御タスク (消費者) が
+ * snapshot() で直近 S 個を読み出す用途を想定する。
+ * 割り込み禁止などの排他制御は不要である。
+ *
+ * - 生産者の push() は待ちなし (wait-free) で O(1)
+ * - 長さ N (> S) のリングバッファに書き込み、通し番号 count を公開する
+ * - 消費者は count を読んでから直近 S 個を複写し、再度 count を読んで、
+ *   複写中に読み出し範囲が上書きされていないかを検証する
+ * - 複写中の push が N - S - 1 回以内であれば検証は必ず成功するので、
+ *   N に余裕を持たせることで再試行はほぼ発生しない
+ * - 各要素は std::atomic<T> の release/acquire アクセスであり、
+ *   x86 では通常のロード・ストアと同じ命令になる
+ * - 単独のメモリフェンスを使わないので、ThreadSanitizer で検証できる
+ *
+ * @code
+ * SpscAccumulator<float, 8> acc;
+ * // 割り込み
+ * acc.push(gyro);
+ * // 制御タスク
+ * const auto gyro_average = acc.snapshot().average();
+ * @endcode
+ *
+ * @tparam T データの型; std::atomic<T> がロックフリーであること
+ * @tparam S 読み出すデータの数
+ * @tparam N リングバッファの長さ; S より大きい 2 のべき乗 (既定は 2S 以上)
+ */
+template <typename T, std::size_t S, std::size_t N = spscDefaultLength(S)>
+class SpscAccumulator {
+  static_assert(S > 0, "S must be positive");
+  static_assert(N > S, "N must be greater than S");
+  static_assert((N & (N - 1)) == 0, "N must be a power of two");
+  static_assert(std::atomic<T>::is_always_lock_free,
+                "std::atomic<T> must be lock-free");
+
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param[in] value バッファ内の全データに代入する初期値
+   */
+  SpscAccumulator(const T& value = T()) { clear(value); }
+  /**
+   * @brief バッファをクリアする関数
+   * @attention 生産者と消費者のいずれも動作していないときに呼ぶこと
+   * @param[in] value 代入する値
+   */
+  void clear(const T& value = T()) {
+    for (auto& b : buffer) b.store(value, std::memory_order_relaxed);
+    count.store(0, std::memory_order_release);
+  }
+  /**
+   * @brief 最新のデータを追加する関数 (生産者のみ)
+   */
+  void push(const T& value) {
+    const auto c = count.load(std::memory_order_relaxed) + 1;
+    /* この値を読んだ消費者には、前回の count の公開が見える */
+    buffer[c & kMask].store(value, std::memory_order_release);
+    count.store(c, std::memory_order_release);
+  }
+  /**
+   * @brief 直近 S 個の複写を1回試みる関数 (消費者のみ)
+   * @param[out] out 直近 S 個; [0] 番目が最新のデータ。失敗時は不定。
+   * @return 複写中に上書きされず、一貫した値が得られたか
+   */
+  bool trySnapshot(Accumulator<T, S>& out) const {
+    const auto c1 = count.load(std::memory_order_acquire);
+    for (std::size_t i = S; i-- > 0;)
+      out.push(buffer[(c1 - i) & kMask].load(std::memory_order_acquire));
+    const auto c2 = count.load(std::memory_order_relaxed);
+    /* 進行中の1回の書き込みも考慮して、上書きの可能性を判定 */
+    return uint32_t(c2 - c1) < N - S;
+  }
+  /**
+   * @brief 直近 S 個を一貫した状態で複写する関数 (消費者のみ)
+   * @details 生産者が割り込みの場合、再試行の回数は割り込みの頻度で抑えられる
+   * @return 直近 S 個; [0] 番目が最新のデータ
+   */
+  Accumulator<T, S> snapshot() const {
+    Accumulator<T, S> out;
+    while (!trySnapshot(out)) continue;
+    return out;
+  }
+  /**
+   * @brief 最新のデータを取得する関数 (消費者のみ)
+   */
+  T latest() const {
+    for (;;) {
+      const auto c1 = count.load(std::memory_order_acquire);
+      const auto value = buffer[c1 & kMask].load(std::memory_order_acquire);
+      const auto c2 = count.load(std::memory_order_relaxed);
+      if (uint32_t(c2 - c1) < N - 1) return value;
+    }
+  }
+  /**
+   * @brief これまでに push された回数 (2^32 で循環)
+   */
+  uint32_t pushed() const { return count.load(std::memory_order_acquire); }
+  /**
+   * @brief 読み出すデータの数を返す関数
+   */
+  std::size_t size() const { return S; }
+
+ private:
+  static constexpr uint32_t kMask = N - 1; /**< @brief 添字のマスク */
+  std::array<std::atomic<T>, N> buffer;     /**< @brief リングバッファ */
+  std::atomic<uint32_t> count;              /**< @brief 最新のデータの通し番号 */
+};
+
+}  // namespace ctrl
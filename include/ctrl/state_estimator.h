@@ -0,0 +1,206 @@
+/**
+ * @file state_estimator.h
+ * @brief 拡張カルマンフィルタによる独立2輪車の状態推定器を定義
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+#include "polar.h"
+#include "pose.h"
+
+/**
+ * @brief 制御関係の名前空間
+ */
+namespace ctrl {
+
+/**
+ * @brief 拡張カルマンフィルタ (EKF) による状態推定器
+ *
+ * 車輪エンコーダ、ジャイロ、壁センサなどによる位置姿勢の補正を融合し、
+ * TrajectoryTracker::update に与える推定値 est_q, est_v, est_a を求める。
+ *
+ * - 状態は [x, y, th, v, w, a, dw] の7次元、加速度は躍度を白色雑音とする
+ * - 行列はすべてオブジェクト内の固定長配列であり、ヒープを使用しない
+ * - 観測はすべて状態の1成分なので、スカラーの逐次更新で処理する。
+ *   逆行列の計算は不要で、1回の更新は O(n^2)
+ * - 予測の共分散 F P F^T は、F が単位行列に近い疎行列であることを利用して
+ *   行と列の基本変形で計算する
+ *
+ * @code
+ * StateEstimator se;
+ * // 制御周期ごと
+ * se.predict(Ts);
+ * se.updateEncoder(v_enc);
+ * se.updateGyro(gyro);
+ * const auto ref = tt.update(se.q(), se.v(), se.a(), s);
+ * @endcode
+ */
+class StateEstimator {
+ public:
+  /**
+   * @brief 状態の添字
+   */
+  enum Index : std::size_t {
+    X,   /**< @brief x 位置 [mm] */
+    Y,   /**< @brief y 位置 [mm] */
+    Th,  /**< @brief 姿勢 [rad] */
+    V,   /**< @brief 並進速度 [mm/s] */
+    W,   /**< @brief 角速度 [rad/s] */
+    A,   /**< @brief 並進加速度 [mm/s/s] */
+    DW,  /**< @brief 角加速度 [rad/s/s] */
+    N,   /**< @brief 状態の次元 */
+  };
+  /**
+   * @brief 雑音の標準偏差
+   * @details 躍度は最大値ではなく推定の帯域で決める。
+   *          大きくすると加速度の推定が速くなる代わりに雑音が増える。
+   */
+  struct Noise {
+    float jerk = 10000;     /**< @brief 並進躍度 [mm/s/s/s] */
+    float ang_jerk = 50;    /**< @brief 角躍度 [rad/s/s/s] */
+    float encoder = 5;      /**< @brief エンコーダの並進速度 [mm/s] */
+    float gyro = 0.01f;     /**< @brief ジャイロの角速度 [rad/s] */
+    float pose_xy = 2;      /**< @brief 位置の補正 [mm] */
+    float pose_th = 0.01f;  /**< @brief 姿勢の補正 [rad] */
+  };
+  using Vector = std::array<float, N>;   /**< @brief 状態ベクトル */
+  using Matrix = std::array<Vector, N>;  /**< @brief 共分散行列 */
+
+ public:
+  /**
+   * @brief 既定の雑音で構築するコンストラクタ
+   */
+  StateEstimator() { reset(); }
+  /**
+   * @brief コンストラクタ
+   * @param[in] noise 雑音の標準偏差
+   */
+  StateEstimator(const Noise& noise) : noise(noise) { reset(); }
+  /**
+   * @brief 状態を既知の値に初期化する関数
+   * @param[in] q 位置姿勢
+   * @param[in] v 速度
+   * @param[in] a 加速度
+   * @param[in] sigma 初期共分散の対角成分の標準偏差
+   */
+  void reset(const Pose& q = {}, const Polar& v = {}, const Polar& a = {},
+             const float sigma = 0) {
+    s = {q.x, q.y, q.th, v.tra, v.rot, a.tra, a.rot};
+    for (std::size_t i = 0; i < N; ++i) {
+      P[i].fill(0);
+      P[i][i] = sigma * sigma;
+    }
+  }
+  /**
+   * @brief 時間を進める予測ステップ
+   * @param[in] dt 経過時間 [s]
+   */
+  void predict(const float dt) {
+    const auto cos_th = std::cos(s[Th]);
+    const auto sin_th = std::sin(s[Th]);
+    /* F = df/ds の非対角成分 (更新前の状態で評価) */
+    const auto fx_th = -s[V] * sin_th * dt, fx_v = cos_th * dt;
+    const auto fy_th = s[V] * cos_th * dt, fy_v = sin_th * dt;
+    /* 状態の遷移 */
+    s[X] += s[V] * cos_th * dt;
+    s[Y] += s[V] * sin_th * dt;
+    s[Th] += s[W] * dt;
+    s[V] += s[A] * dt;
+    s[W] += s[DW] * dt;
+    /* P <- F P; 参照される行より先に、参照する行を更新する */
+    rowOp(X, Th, fx_th), rowOp(X, V, fx_v);
+    rowOp(Y, Th, fy_th), rowOp(Y, V, fy_v);
+    rowOp(Th, W, dt), rowOp(V, A, dt), rowOp(W, DW, dt);
+    /* P <- P F^T */
+    colOp(X, Th, fx_th), colOp(X, V, fx_v);
+    colOp(Y, Th, fy_th), colOp(Y, V, fy_v);
+    colOp(Th, W, dt), colOp(V, A, dt), colOp(W, DW, dt);
+    /* P <- P + Q */
+    P[A][A] += noise.jerk * noise.jerk * dt;
+    P[DW][DW] += noise.ang_jerk * noise.ang_jerk * dt;
+  }
+  /**
+   * @brief 車輪エンコーダの並進速度による更新ステップ
+   * @param[in] v 左右の車輪速度の平均 [mm/s]
+   */
+  void updateEncoder(const float v) { update(V, v, noise.encoder); }
+  /**
+   * @brief ジャイロの角速度による更新ステップ
+   * @param[in] w 角速度 [rad/s]
+   */
+  void updateGyro(const float w) { update(W, w, noise.gyro); }
+  /**
+   * @brief 位置姿勢の補正による更新ステップ
+   * @param[in] q 壁センサなどから求めた位置姿勢
+   */
+  void updatePose(const Pose& q) {
+    update(X, q.x, noise.pose_xy);
+    update(Y, q.y, noise.pose_xy);
+    update(Th, q.th, noise.pose_th);
+  }
+  /**
+   * @brief 状態の1成分の観測による更新ステップ
+   * @details 壁センサで1方向の位置のみが得られた場合などに使用する
+   * @param[in] i 観測する状態の添字
+   * @param[in] z 観測値
+   * @param[in] sigma 観測雑音の標準偏差
+   */
+  void update(const Index i, const float z, const float sigma) {
+    /* H = e_i なので、K = P[:, i] / (P[i][i] + r) */
+    const auto S = P[i][i] + sigma * sigma;
+    const auto innovation = z - s[i];
+    Vector K;
+    for (std::size_t r = 0; r < N; ++r) K[r] = P[r][i] / S;
+    const auto Pi = P[i];
+    for (std::size_t r = 0; r < N; ++r) {
+      s[r] += K[r] * innovation;
+      for (std::size_t c = 0; c < N; ++c) P[r][c] -= K[r] * Pi[c];
+    }
+  }
+  /**
+   * @brief 推定位置姿勢
+   */
+  Pose q() const { return {s[X], s[Y], s[Th]}; }
+  /**
+   * @brief 推定速度
+   */
+  Polar v() const { return {s[V], s[W]}; }
+  /**
+   * @brief 推定加速度
+   */
+  Polar a() const { return {s[A], s[DW]}; }
+  /**
+   * @brief 状態ベクトル
+   */
+  const Vector& state() const { return s; }
+  /**
+   * @brief 共分散行列
+   */
+  const Matrix& covariance() const { return P; }
+
+ private:
+  Noise noise; /**< @brief 雑音の標準偏差 */
+  Vector s;    /**< @brief 状態ベクトル */
+  Matrix P;    /**< @brief 共分散行列 */
+
+  /**
+   * @brief 行の基本変形 P[i][:] += f * P[k][:]
+   */
+  void rowOp(const std::size_t i, const std::size_t k, const float f) {
+    for (std::size_t c = 0; c < N; ++c) P[i][c] += f * P[k][c];
+  }
+  /**
+   * @brief 列の基本変形 P[:][i] += f * P[:][k]
+   */
+  void colOp(const std::size_t i, const std::size_t k, const float f) {
+    for (std::size_t r = 0; r < N; ++r) P[r][i] += f * P[r][k];
+  }
+};
+
+}  // namespace ctrl
@@ -10,6 +10,8 @@
 #include <ctrl/accel_designer.h>
 #include <ctrl/state.h>
 
+#include <cstddef>
+
 /**
  * @brief 制御関係の名前空間
  */
@@ -21,17 +23,19 @@ namespace ctrl {
 namespace straight {
 
 /**
- * @brief straight::Trajectory 直線の軌道生成器
+ * @brief straight::BasicTrajectory 直線の軌道生成器
  *
  * ctrl::TrajectoryTracker のために用意されたクラス
+ * @tparam D 速度設計器; AccelDesigner または AccelDesignerFixed
  */
-class Trajectory : public AccelDesigner {
+template <typename D = AccelDesigner>
+class BasicTrajectory : public D {
  public:
   /**
    * @brief 空のコンストラクタ。
-   * 基底クラスの AccelDesigner::reset() により初期化すること。
+   * 基底クラスの reset() により初期化すること。
    */
-  Trajectory() {}
+  BasicTrajectory() {}
   /**
    * @brief 状態の更新
    *
@@ -39,12 +43,50 @@ class Trajectory : public AccelDesigner {
    * @param[in] t 現在時刻
    */
   void update(struct State& s, const float t) const {
-    s.q = Pose(x(t), 0, 0);
-    s.dq = Pose(v(t), 0, 0);
-    s.ddq = Pose(a(t), 0, 0);
-    s.dddq = Pose(j(t), 0, 0);
+    s.q = Pose(this->x(t), 0, 0);
+    s.dq = Pose(this->v(t), 0, 0);
+    s.ddq = Pose(this->a(t), 0, 0);
+    s.dddq = Pose(this->j(t), 0, 0);
+  }
+  /**
+   * @brief 一定周期で状態を配列に書き込む関数
+   *
+   * @details 曲線は BasicAccelDesigner::Walker により区間を順にたどって
+   * 評価するので、update() のように時刻ごとに区間を探索しない。
+   * update() を順に呼ぶのと丸め誤差の範囲で一致する。
+   * 時刻は整数の周期数から算出するので、誤差が累積しない。
+   * @param[in] t 開始時刻 [s]
+   * @param[in] Ts 周期 [s]
+   * @param[out] out 時刻 t + i * Ts の状態を格納する長さ n の配列
+   * @param[in] n 要素数
+   */
+  void rollout(const float t, const float Ts, struct State* out,
+               const std::size_t n) const {
+    BasicAccelDesigner::Walker w(*this);
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto e = w.at(t + static_cast<float>(i) * Ts);
+      out[i].q = Pose(e.x, 0, 0);
+      out[i].dq = Pose(e.v, 0, 0);
+      out[i].ddq = Pose(e.a, 0, 0);
+      out[i].dddq = Pose(e.j, 0, 0);
+    }
+  }
+  /**
+   * @brief 開始時刻から一定周期で状態を配列に書き込む関数
+   *
+   * @param[in] Ts 周期 [s]
+   * @param[out] out 開始時刻から i * Ts 後の状態を格納する長さ n の配列
+   * @param[in] n 要素数
+   */
+  void rollout(const float Ts, struct State* out, const std::size_t n) const {
+    rollout(this->t_0(), Ts, out, n);
   }
 };
 
+/**
+ * @brief straight::Trajectory 実行時に最大躍度と最大加速度を与える直線の軌道生成器
+ */
+using Trajectory = BasicTrajectory<>;
+
 }  // namespace straight
 }  // namespace ctrl
@@ -0,0 +1,165 @@
+/**
+ * @file telemetry.h
+ * @brief 制御周期ごとの内部状態を固定長のバイナリレコードとして記録する
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-08
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "feedback_controller.h"
+#include "polar.h"
+#include "pose.h"
+#include "state.h"
+#include "trajectory_tracker.h"
+
+/**
+ * @brief 制御関係の名前空間
+ */
+namespace ctrl {
+
+/**
+ * @brief テレメトリファイルのレイアウトの版
+ * @details TelemetryRecord や TelemetryFileHeader のレイアウトを変更した場合は
+ *          更新し、tools/telemetry.py の VERSION も合わせること
+ */
+static constexpr uint16_t kTelemetryVersion = 1;
+
+/**
+ * @brief 1制御周期分のテレメトリレコード
+ *
+ * - すべてのメンバーが4バイトであり、パディングなしで詰めて配置される
+ * - ファイルにはこの構造体をそのまま書き出す (リトルエンディアン)
+ * - レイアウトを変更した場合は kTelemetryVersion を更新すること
+ */
+struct TelemetryRecord {
+  uint32_t tick;                          /**< @brief 制御周期のカウント */
+  Pose est_q;                             /**< @brief 推定位置 */
+  Polar est_v;                            /**< @brief 推定速度 */
+  Polar est_a;                            /**< @brief 推定加速度 */
+  State ref;                              /**< @brief 目標状態 */
+  TrajectoryTracker::Result tracker;      /**< @brief 軌道追従器の出力 */
+  FeedbackController<Polar>::Breakdown bd; /**< @brief 制御入力の内訳 */
+};
+static_assert(sizeof(TelemetryRecord) == 36 * 4,
+              "TelemetryRecord must be packed without padding");
+static_assert(std::is_trivially_copyable<TelemetryRecord>::value,
+              "TelemetryRecord must be trivially copyable");
+
+/**
+ * @brief テレメトリファイルのヘッダ
+ *
+ * ファイルはこのヘッダの後に TelemetryRecord が連続して並ぶ。
+ */
+struct TelemetryFileHeader {
+  char magic[4] = {'M', 'M', 'T', 'L'};     /**< @brief 識別子 */
+  uint16_t version = kTelemetryVersion;     /**< @brief レイアウトの版 */
+  uint16_t record_size = sizeof(TelemetryRecord); /**< @brief レコード長 */
+};
+static_assert(sizeof(TelemetryFileHeader) == 8,
+              "TelemetryFileHeader must be 8 bytes");
+
+/**
+ * @brief 固定長リングバッファによるテレメトリ記録器
+ *
+ * - 制御タスク (単一の書き込み側) が record() を呼び、
+ *   ダンプタスク (単一の読み出し側) が read() でレコードを取り出す
+ * - 動的メモリ確保は行わず、書き込み側・読み出し側ともにロックしない
+ * - バッファが満杯のときは新しいレコードを破棄し、破棄数を数える
+ *
+ * @tparam S 保持するレコード数、2の累乗であること
+ */
+template <std::size_t S>
+class TelemetryRecorder {
+  static_assert(S > 0 && (S & (S - 1)) == 0, "S must be a power of two");
+
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param[in] decimation 何周期に1回記録するか (1 で毎周期)
+   */
+  explicit TelemetryRecorder(const uint32_t decimation = 1) {
+    setDecimation(decimation);
+  }
+  /**
+   * @brief 間引き数を設定する関数
+   * @param[in] decimation 何周期に1回記録するか (0 は 1 とみなす)
+   */
+  void setDecimation(const uint32_t decimation) {
+    this->decimation = decimation > 0 ? decimation : 1;
+    countdown = 0;
+  }
+  /**
+   * @brief 1周期分の状態を記録する関数 (書き込み側)
+   * @details 間引きにより記録しない周期でも tick は進む。
+   * @return 記録した場合 true、間引きまたは満杯により記録しなかった場合 false
+   */
+  bool record(const Pose& est_q, const Polar& est_v, const Polar& est_a,
+              const State& ref, const TrajectoryTracker::Result& tracker,
+              const FeedbackController<Polar>::Breakdown& bd) {
+    const auto t = tick++;
+    if (countdown != 0) return --countdown, false;
+    countdown = decimation - 1;
+    const auto h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= S)
+      return drop_count.fetch_add(1, std::memory_order_relaxed), false;
+    auto& r = buffer[h & (S - 1)];
+    r.tick = t;
+    r.est_q = est_q;
+    r.est_v = est_v;
+    r.est_a = est_a;
+    r.ref = ref;
+    r.tracker = tracker;
+    r.bd = bd;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+  /**
+   * @brief 記録済みのレコードを取り出す関数 (読み出し側)
+   * @param[out] out 取り出し先の配列
+   * @param[in] n 取り出し先の配列長
+   * @return 取り出したレコード数
+   */
+  std::size_t read(TelemetryRecord* out, const std::size_t n) {
+    const auto t = tail.load(std::memory_order_relaxed);
+    const auto h = head.load(std::memory_order_acquire);
+    const std::size_t available = h - t;
+    const auto count = available < n ? available : n;
+    for (std::size_t i = 0; i < count; ++i) out[i] = buffer[(t + i) & (S - 1)];
+    tail.store(t + count, std::memory_order_release);
+    return count;
+  }
+  /**
+   * @brief 取り出し可能なレコード数
+   */
+  std::size_t available() const {
+    return head.load(std::memory_order_acquire) -
+           tail.load(std::memory_order_relaxed);
+  }
+  /**
+   * @brief 満杯のため破棄したレコード数
+   */
+  uint32_t dropped() const {
+    return drop_count.load(std::memory_order_relaxed);
+  }
+  /**
+   * @brief バッファの容量
+   */
+  static constexpr std::size_t capacity() { return S; }
+
+ private:
+  std::array<TelemetryRecord, S> buffer; /**< @brief レコードの保存領域 */
+  std::atomic<uint32_t> head{0};       /**< @brief 書き込み済みの総数 */
+  std::atomic<uint32_t> tail{0};       /**< @brief 読み出し済みの総数 */
+  std::atomic<uint32_t> drop_count{0}; /**< @brief 破棄したレコード数 */
+  uint32_t tick = 0;                   /**< @brief 制御周期のカウント */
+  uint32_t decimation = 1;             /**< @brief 間引き数 */
+  uint32_t countdown = 0;              /**< @brief 次の記録までの周期数 */
+};
+
+}  // namespace ctrl
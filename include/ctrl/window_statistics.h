@@ -0,0 +1,353 @@
+/**
+ * @file window_statistics.h
+ * @brief 直近 S 個のデータの統計量を逐次更新するクラスを定義
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <functional>  //< for std::less, std::greater
+#include <type_traits>
+#include <utility>  //< for std::swap
+
+#include "accumulator.h"
+
+/**
+ * @brief 制御関係の名前空間
+ */
+namespace ctrl {
+
+/**
+ * @brief 直近 S 個のデータの平均と分散を O(1) で更新するクラス
+ *
+ * - Welford 法を窓の入れ替えに拡張した更新式を用いる
+ * - 浮動小数点数では、丸め誤差の累積を防ぐため、
+ *   窓が一巡する間に追加されたデータのみから追加のみの Welford 法で
+ *   平均と偏差の2乗和を別途求めておき、一巡するごとに置き換える (最悪 O(1))
+ * - Accumulator と同様に、窓は初期値で満たされた状態から始まる
+ *
+ * @tparam T データの型 (浮動小数点数)
+ * @tparam S 窓の大きさ
+ */
+template <typename T, std::size_t S>
+class WindowVariance {
+  static_assert(std::is_floating_point<T>::value, "T must be floating point");
+
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param[in] value 窓内の全データに代入する初期値
+   */
+  WindowVariance(const T& value = T()) { clear(value); }
+  /**
+   * @brief 窓をクリアする関数
+   * @param[in] value 代入する値
+   */
+  void clear(const T& value = T()) {
+    acc.clear(value);
+    mean_ = value;
+    m2 = 0;
+    count = 0;
+    lap_mean = 0;
+    lap_m2 = 0;
+  }
+  /**
+   * @brief 最新のデータを追加する関数
+   */
+  void push(const T& value) {
+    const auto oldest = acc[S - 1];
+    acc.push(value);
+    /* 今回の一巡で追加されたデータの統計量 */
+    const auto delta = value - lap_mean;
+    lap_mean += delta / ++count;
+    lap_m2 += delta * (value - lap_mean);
+    if (count == S) {
+      /* 窓全体が今回の一巡のデータとなったので置き換える */
+      mean_ = lap_mean, m2 = lap_m2;
+      count = 0, lap_mean = 0, lap_m2 = 0;
+      return;
+    }
+    const auto mean_prev = mean_;
+    mean_ += (value - oldest) / S;
+    m2 += (value - oldest) * (value - mean_ + oldest - mean_prev);
+    if (m2 < 0) m2 = 0;  //< 丸め誤差による負値を防ぐ
+  }
+  /**
+   * @brief 窓内のデータ
+   */
+  const Accumulator<T, S>& window() const { return acc; }
+  /**
+   * @brief 平均
+   */
+  T mean() const { return mean_; }
+  /**
+   * @brief 分散 (母分散; S で割る)
+   */
+  T variance() const { return m2 / S; }
+  /**
+   * @brief 標準偏差 (母標準偏差)
+   */
+  T stddev() const { return std::sqrt(variance()); }
+
+ private:
+  Accumulator<T, S> acc; /**< @brief 窓内のデータ */
+  T mean_;               /**< @brief 平均 */
+  T m2;                  /**< @brief 平均からの偏差の2乗和 */
+  std::size_t count;     /**< @brief 今回の一巡での push 回数 */
+  T lap_mean;            /**< @brief 今回の一巡のデータの平均 */
+  T lap_m2;              /**< @brief 今回の一巡のデータの偏差の2乗和 */
+};
+
+/**
+ * @brief 直近 S 個のデータの最小値または最大値を償却 O(1) で更新するクラス
+ *
+ * 単調キュー (monotonic deque) により、最新から遡って
+ * Compare の意味で単調となる候補のみを保持する。
+ * 候補のキューは固定長のリングバッファであり、メモリを確保しない。
+ *
+ * @tparam T データの型
+ * @tparam S 窓の大きさ
+ * @tparam Compare 比較関数; std::less なら最小値、std::greater なら最大値
+ */
+template <typename T, std::size_t S, typename Compare>
+class WindowExtremum {
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param[in] value 窓内の全データに代入する初期値
+   */
+  WindowExtremum(const T& value = T()) { clear(value); }
+  /**
+   * @brief 窓をクリアする関数
+   * @param[in] value 代入する値
+   */
+  void clear(const T& value = T()) {
+    /* 同値の候補は最新のもののみ残るので、1つとなる */
+    tick = S - 1;
+    front = 0;
+    n = 1;
+    queue[0] = {value, tick};
+  }
+  /**
+   * @brief 最新のデータを追加する関数
+   */
+  void push(const T& value) {
+    ++tick;
+    /* 窓から外れた候補を先頭から削除 */
+    if (queue[front].tick + S <= tick) front = (front + 1) % S, --n;
+    /* 新しい値に優る候補を末尾から削除 */
+    while (n > 0 && !compare(queue[(front + n - 1) % S].value, value)) --n;
+    queue[(front + n) % S] = {value, tick};
+    ++n;
+  }
+  /**
+   * @brief 窓内の極値
+   */
+  const T& value() const { return queue[front].value; }
+
+ private:
+  /**
+   * @brief 候補
+   */
+  struct Entry {
+    T value;          /**< @brief 値 */
+    std::size_t tick; /**< @brief 追加された時の通し番号 */
+  };
+  std::array<Entry, S> queue; /**< @brief 候補のリングバッファ */
+  std::size_t front;          /**< @brief 先頭の添字 */
+  std::size_t n;              /**< @brief 候補の数 */
+  std::size_t tick;           /**< @brief 最新のデータの通し番号 */
+  Compare compare;            /**< @brief 比較関数 */
+};
+
+/**
+ * @brief 直近 S 個のデータの最小値と最大値を償却 O(1) で更新するクラス
+ * @tparam T データの型
+ * @tparam S 窓の大きさ
+ */
+template <typename T, std::size_t S>
+class WindowMinMax {
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param[in] value 窓内の全データに代入する初期値
+   */
+  WindowMinMax(const T& value = T()) : min_(value), max_(value) {}
+  /**
+   * @brief 窓をクリアする関数
+   * @param[in] value 代入する値
+   */
+  void clear(const T& value = T()) { min_.clear(value), max_.clear(value); }
+  /**
+   * @brief 最新のデータを追加する関数
+   */
+  void push(const T& value) { min_.push(value), max_.push(value); }
+  /**
+   * @brief 窓内の最小値
+   */
+  const T& min() const { return min_.value(); }
+  /**
+   * @brief 窓内の最大値
+   */
+  const T& max() const { return max_.value(); }
+
+ private:
+  WindowExtremum<T, S, std::less<T>> min_;    /**< @brief 最小値 */
+  WindowExtremum<T, S, std::greater<T>> max_; /**< @brief 最大値 */
+};
+
+/**
+ * @brief 直近 S 個のデータの中央値を O(log S) で更新するクラス
+ *
+ * - 窓を下半分の最大ヒープと上半分の最小ヒープに分けて保持する
+ * - 各データのヒープ内の位置を記録しておくことで、
+ *   窓から外れる最古のデータを新しいデータでその場で置き換えられる
+ * - 置き換え後は、ヒープ内のふるい分けと、両ヒープの先頭の交換 (高々1回) で
+ *   「下半分 <= 上半分」の関係が回復する
+ * - すべて固定長の配列であり、メモリを確保しない
+ *
+ * @tparam T データの型
+ * @tparam S 窓の大きさ
+ */
+template <typename T, std::size_t S>
+class WindowMedian {
+  static_assert(S >= 2, "S must be 2 or more");
+
+ public:
+  /**
+   * @brief コンストラクタ
+   * @param[in] value 窓内の全データに代入する初期値
+   */
+  WindowMedian(const T& value = T()) { clear(value); }
+  /**
+   * @brief 窓をクリアする関数
+   * @param[in] value 代入する値
+   */
+  void clear(const T& value = T()) {
+    values.fill(value);
+    oldest = 0;
+    for (std::size_t i = 0; i < kLo; ++i) lo[i] = i, where[i] = {true, i};
+    for (std::size_t i = 0; i < kHi; ++i)
+      hi[i] = kLo + i, where[kLo + i] = {false, i};
+  }
+  /**
+   * @brief 最新のデータを追加する関数
+   */
+  void push(const T& value) {
+    /* 最古のデータをその場で置き換える */
+    const auto s = oldest;
+    oldest = (oldest + 1) % S;
+    values[s] = value;
+    const auto w = where[s];
+    if (w.lo)
+      sift<true>(w.i);
+    else
+      sift<false>(w.i);
+    /* 下半分の最大 > 上半分の最小 となった場合は先頭同士を交換 */
+    if (values[lo[0]] > values[hi[0]]) {
+      std::swap(lo[0], hi[0]);
+      where[lo[0]] = {true, 0};
+      where[hi[0]] = {false, 0};
+      siftDown<true>(0);
+      siftDown<false>(0);
+    }
+  }
+  /**
+   * @brief 窓内の中央値; S が偶数の場合は中央の2値の平均
+   */
+  T median() const {
+    if constexpr (S % 2 == 1)
+      return values[lo[0]];
+    else
+      return (values[lo[0]] + values[hi[0]]) / 2;
+  }
+
+ private:
+  static constexpr std::size_t kLo = (S + 1) / 2; /**< @brief 下半分の数 */
+  static constexpr std::size_t kHi = S - kLo;     /**< @brief 上半分の数 */
+  /**
+   * @brief データのヒープ内の位置
+   */
+  struct Where {
+    bool lo;       /**< @brief 下半分のヒープにあるか */
+    std::size_t i; /**< @brief ヒープ内の添字 */
+  };
+  std::array<T, S> values;         /**< @brief 窓内のデータ (到着順) */
+  std::array<std::size_t, kLo> lo; /**< @brief 下半分の最大ヒープ */
+  std::array<std::size_t, kHi> hi; /**< @brief 上半分の最小ヒープ */
+  std::array<Where, S> where;      /**< @brief 各データの位置 */
+  std::size_t oldest;              /**< @brief 最古のデータの添字 */
+
+  /**
+   * @brief ヒープ内で a が b より先頭側にあるべきか
+   */
+  template <bool Lo>
+  bool before(const std::size_t a, const std::size_t b) const {
+    return Lo ? values[a] > values[b] : values[a] < values[b];
+  }
+  /**
+   * @brief ヒープの要素を交換する関数
+   */
+  template <bool Lo>
+  void swapAt(const std::size_t i, const std::size_t j) {
+    auto& heap = heapOf<Lo>();
+    std::swap(heap[i], heap[j]);
+    where[heap[i]].i = i;
+    where[heap[j]].i = j;
+  }
+  /**
+   * @brief ヒープの配列
+   */
+  template <bool Lo>
+  auto& heapOf() {
+    if constexpr (Lo)
+      return lo;
+    else
+      return hi;
+  }
+  /**
+   * @brief i 番目の要素を先頭側へふるい上げる関数
+   * @return 移動したか
+   */
+  template <bool Lo>
+  bool siftUp(std::size_t i) {
+    const auto& heap = heapOf<Lo>();
+    const auto i0 = i;
+    while (i > 0) {
+      const auto parent = (i - 1) / 2;
+      if (!before<Lo>(heap[i], heap[parent])) break;
+      swapAt<Lo>(i, parent);
+      i = parent;
+    }
+    return i != i0;
+  }
+  /**
+   * @brief i 番目の要素を末尾側へふるい下げる関数
+   */
+  template <bool Lo>
+  void siftDown(std::size_t i) {
+    const auto& heap = heapOf<Lo>();
+    const auto n = heap.size();
+    for (;;) {
+      auto top = i;
+      for (const auto c : {2 * i + 1, 2 * i + 2})
+        if (c < n && before<Lo>(heap[c], heap[top])) top = c;
+      if (top == i) break;
+      swapAt<Lo>(i, top);
+      i = top;
+    }
+  }
+  /**
+   * @brief 値が変化した i 番目の要素をふるい分ける関数
+   */
+  template <bool Lo>
+  void sift(const std::size_t i) {
+    if (!siftUp<Lo>(i)) siftDown<Lo>(i);
+  }
+};
+
+}  // namespace ctrl
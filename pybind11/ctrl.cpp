@@ -6,15 +6,468 @@
  * @copyright Copyright 2020 Ryotaro Onuki <kerikun11+github@gmail.com>
  */
 #include <ctrl/accel_designer.h>
+#include <ctrl/accumulator.h>
+#include <ctrl/feedback_controller.h>
+#include <ctrl/polar.h>
 #include <ctrl/slalom/trajectory.h>
+#include <ctrl/straight/trajectory.h>
+#include <ctrl/trajectory_tracker.h>
+#include <pybind11/numpy.h>
 #include <pybind11/operators.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <optional>
 #include <sstream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace py = pybind11;
+
+/**
+ * @brief input array of float32 (float64 and others are converted)
+ */
+using FloatArray =
+    py::array_t<float, py::array::c_style | py::array::forcecast>;
+
+/**
+ * @brief evaluate j, a, v, x at every point of t with the GIL released
+ * @tparam T AccelCurve or AccelDesigner
+ * @return tuple of arrays (j, a, v, x), each of the same shape as t
+ */
+template <typename T>
+py::tuple sample(const T& obj, const FloatArray& t) {
+  const std::vector<py::ssize_t> shape(t.shape(), t.shape() + t.ndim());
+  FloatArray j(shape), a(shape), v(shape), x(shape);
+  const auto n = t.size();
+  const float* pt = t.data();
+  float* pj = j.mutable_data();
+  float* pa = a.mutable_data();
+  float* pv = v.mutable_data();
+  float* px = x.mutable_data();
+  {
+    py::gil_scoped_release release;
+    for (py::ssize_t i = 0; i < n; ++i) {
+      pj[i] = obj.j(pt[i]);
+      pa[i] = obj.a(pt[i]);
+      pv[i] = obj.v(pt[i]);
+      px[i] = obj.x(pt[i]);
+    }
+  }
+  return py::make_tuple(j, a, v, x);
+}
+
+/**
+ * @brief integrate a slalom trajectory for n steps of Ts with the GIL released
+ * @details integration starts from ctrl::State() at t_start;
+ * states[i] is the state at time t[i] = t_start + i * Ts, where states[0]
+ * has only the derivatives at t_start set (the same time base as
+ * StraightTrajectory.rollout_into and the closed-loop rollout)
+ * @return tuple (t, states) of shapes (n,) and (n, 4, 3),
+ * where axis 1 is (q, dq, ddq, dddq) and axis 2 is (x, y, th)
+ */
+py::tuple rollout(const ctrl::slalom::Trajectory& trajectory, const float Ts,
+                  const py::ssize_t n, const float t_start,
+                  const float k_slip) {
+  static_assert(sizeof(ctrl::State) == 12 * sizeof(float),
+                "State must be 12 packed floats");
+  FloatArray t(n);
+  FloatArray states(std::vector<py::ssize_t>{n, 4, 3});
+  float* pt = t.mutable_data();
+  auto* ps = reinterpret_cast<ctrl::State*>(states.mutable_data());
+  {
+    py::gil_scoped_release release;
+    ctrl::State s;
+    trajectory.rollout(s, t_start, Ts, ps, n, k_slip);
+    for (py::ssize_t i = 0; i < n; ++i) pt[i] = t_start + i * Ts;
+  }
+  return py::make_tuple(t, states);
+}
+
+/**
+ * @brief contiguous array of T exposed to Python through the buffer protocol
+ * @details numpy.asarray() gives a zero-copy structured view;
+ * the size is fixed at construction so that the storage never moves
+ * under a view
+ */
+template <typename T>
+struct Array {
+  std::vector<T> items;
+};
+using StateArray = Array<ctrl::State>;
+using PoseArray = Array<ctrl::Pose>;
+
+/**
+ * @brief bind Array<T>; the numpy dtype of T must be registered beforehand
+ */
+template <typename T>
+void bindArray(py::module_& m, const char* name) {
+  using A = Array<T>;
+  const auto index = [](const A& a, py::ssize_t i) {
+    const auto n = static_cast<py::ssize_t>(a.items.size());
+    if (i < 0) i += n;
+    if (i < 0 || i >= n) throw py::index_error();
+    return static_cast<std::size_t>(i);
+  };
+  py::class_<A>(m, name, py::buffer_protocol())
+      .def(py::init([](const std::size_t n) {
+             A a;
+             a.items.resize(n);
+             return a;
+           }),
+           py::arg("n") = 0)
+      .def_buffer([](A& a) {
+        return py::buffer_info(a.items.data(), sizeof(T),
+                               py::format_descriptor<T>::format(), 1,
+                               {a.items.size()}, {sizeof(T)});
+      })
+      .def("__len__", [](const A& a) { return a.items.size(); })
+      .def(
+          "__getitem__",
+          [index](A& a, const py::ssize_t i) -> T& {
+            return a.items[index(a, i)];
+          },
+          py::return_value_policy::reference_internal)
+      .def("__setitem__", [index](A& a, const py::ssize_t i,
+                                  const T& value) { a.items[index(a, i)] = value; })
+      //
+      ;
+}
+
+/**
+ * @brief store the part of a state kept by an output array
+ */
+void store(ctrl::State& out, const ctrl::State& s) { out = s; }
+void store(ctrl::Pose& out, const ctrl::State& s) { out = s.q; }
+
+/**
+ * @brief integrate a slalom trajectory into every element of out
+ * @details same time base as rollout(): out[i] is the state at
+ * t_start + i * Ts; poses are integrated through a small buffer of states
+ */
+template <typename T>
+void rolloutInto(const ctrl::slalom::Trajectory& trajectory, Array<T>& out,
+                 const float Ts, const float t_start, const float k_slip) {
+  py::gil_scoped_release release;
+  ctrl::State s;
+  const auto n = out.items.size();
+  if constexpr (std::is_same_v<T, ctrl::State>) {
+    trajectory.rollout(s, t_start, Ts, out.items.data(), n, k_slip);
+  } else {
+    /* buf[0] of each chunk repeats the last state of the previous one */
+    std::array<ctrl::State, 256> buf;
+    for (std::size_t i = 0; i < n;) {
+      const std::size_t skip = i > 0;
+      const auto m = std::min(buf.size() - skip, n - i);
+      trajectory.rollout(s, t_start + (i - skip) * Ts, Ts, buf.data(),
+                         m + skip, k_slip);
+      for (std::size_t k = 0; k < m; ++k)
+        store(out.items[i + k], buf[skip + k]);
+      i += m;
+    }
+  }
+}
+
+/**
+ * @brief sample a straight trajectory into every element of out
+ * @details out[i] is the state at t_start + i * Ts
+ */
+template <typename T>
+void rolloutInto(const ctrl::straight::Trajectory& trajectory, Array<T>& out,
+                 const float Ts, const float t_start) {
+  py::gil_scoped_release release;
+  if constexpr (std::is_same_v<T, ctrl::State>) {
+    trajectory.rollout(t_start, Ts, out.items.data(), out.items.size());
+  } else {
+    ctrl::State s;
+    for (std::size_t i = 0; i < out.items.size(); ++i) {
+      trajectory.update(s, t_start + i * Ts);
+      store(out.items[i], s);
+    }
+  }
+}
+
+/**
+ * @brief convert a Pose or a sequence (x, y, th) to ctrl::Pose
+ */
+ctrl::Pose toPose(const py::handle& h) {
+  if (py::isinstance<ctrl::Pose>(h)) return h.cast<ctrl::Pose>();
+  const auto seq = h.cast<py::sequence>();
+  return {seq[0].cast<float>(), seq[1].cast<float>(), seq[2].cast<float>()};
+}
+
+/**
+ * @brief constraints of ctrl::slalom::Shape parsed from a Python object
+ */
+struct ShapeParams {
+  ctrl::Pose total;
+  float y_curve_end;
+  float x_adv = 0;
+  float dddth_max = ctrl::slalom::dddth_max_default;
+  float ddth_max = ctrl::slalom::ddth_max_default;
+  float dth_max = ctrl::slalom::dth_max_default;
+};
+
+/**
+ * @brief parse a dict with the keyword arguments of ctrl.Shape, or a tuple
+ * (total, y_curve_end[, x_adv[, dddth_max[, ddth_max[, dth_max]]]])
+ */
+ShapeParams toShapeParams(const py::handle& h) {
+  ShapeParams p;
+  if (py::isinstance<py::dict>(h)) {
+    const auto d = h.cast<py::dict>();
+    p.total = toPose(d["total"]);
+    p.y_curve_end = d["y_curve_end"].cast<float>();
+    if (d.contains("x_adv")) p.x_adv = d["x_adv"].cast<float>();
+    if (d.contains("dddth_max")) p.dddth_max = d["dddth_max"].cast<float>();
+    if (d.contains("ddth_max")) p.ddth_max = d["ddth_max"].cast<float>();
+    if (d.contains("dth_max")) p.dth_max = d["dth_max"].cast<float>();
+    return p;
+  }
+  const auto seq = h.cast<py::sequence>();
+  const auto n = seq.size();
+  if (n < 2) throw py::value_error("shape params need total and y_curve_end");
+  p.total = toPose(seq[0]);
+  p.y_curve_end = seq[1].cast<float>();
+  if (n > 2) p.x_adv = seq[2].cast<float>();
+  if (n > 3) p.dddth_max = seq[3].cast<float>();
+  if (n > 4) p.ddth_max = seq[4].cast<float>();
+  if (n > 5) p.dth_max = seq[5].cast<float>();
+  return p;
+}
+
+/**
+ * @brief build slalom shapes on a thread pool with the GIL released
+ * @param[in] params list of shape params (see toShapeParams)
+ * @param[in] threads number of worker threads (0: hardware concurrency)
+ * @param[in] as_array return a structured array instead of a list of Shape
+ */
+py::object buildShapes(const py::iterable& params, const unsigned threads,
+                       const bool as_array) {
+  std::vector<ShapeParams> ps;
+  for (const auto& h : params) ps.push_back(toShapeParams(h));
+  const auto n = ps.size();
+  std::vector<ctrl::slalom::Shape> shapes(
+      n, ctrl::slalom::Shape(ctrl::Pose(), ctrl::Pose(), 0, 0, 0, 0, 0, 0));
+  {
+    py::gil_scoped_release release;
+    std::atomic<std::size_t> next{0};
+    const auto worker = [&]() {
+      for (std::size_t i; (i = next.fetch_add(1)) < n;) {
+        const auto& p = ps[i];
+        shapes[i] = ctrl::slalom::Shape(p.total, p.y_curve_end, p.x_adv,
+                                        p.dddth_max, p.ddth_max, p.dth_max);
+      }
+    };
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t n_threads =
+        std::min<std::size_t>(threads ? threads : hw, n);
+    std::vector<std::thread> pool;
+    for (std::size_t k = 1; k < n_threads; ++k) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+  }
+  if (!as_array) return py::cast(shapes);
+  /* structured array whose fields follow the member order of Shape */
+  static_assert(sizeof(ctrl::slalom::Shape) == 12 * sizeof(float),
+                "Shape must be 12 packed floats");
+  const auto count = static_cast<py::ssize_t>(n);
+  FloatArray raw(std::vector<py::ssize_t>{count, 12});
+  std::memcpy(raw.mutable_data(), shapes.data(), n * sizeof(shapes[0]));
+  py::list fields;
+  for (const auto name :
+       {"total.x", "total.y", "total.th", "curve.x", "curve.y", "curve.th",
+        "straight_prev", "straight_post", "v_ref", "dddth_max", "ddth_max",
+        "dth_max"})
+    fields.append(py::make_tuple(name, "<f4"));
+  const auto dtype = py::module_::import("numpy").attr("dtype")(fields);
+  return raw.attr("view")(dtype).attr("reshape")(count);
+}
+
+/**
+ * @brief bind ctrl::FeedbackController<T> with its nested structs
+ */
+template <typename T>
+void bindFeedbackController(py::module_& m, const char* name) {
+  using FC = ctrl::FeedbackController<T>;
+  using Model = typename FC::Model;
+  using Gain = typename FC::Gain;
+  using Breakdown = typename FC::Breakdown;
+  py::class_<FC> fc(m, name);
+  py::class_<Model>(fc, "Model")
+      .def(py::init<>())
+      .def(py::init([](const T& K1, const T& T1) { return Model{K1, T1}; }),
+           py::arg("K1"), py::arg("T1"))
+      .def_readwrite("K1", &Model::K1)
+      .def_readwrite("T1", &Model::T1)
+      //
+      ;
+  py::class_<Gain>(fc, "Gain")
+      .def(py::init<>())
+      .def(py::init([](const T& Kp, const T& Ki, const T& Kd) {
+             return Gain{Kp, Ki, Kd};
+           }),
+           py::arg("Kp"), py::arg("Ki"), py::arg("Kd"))
+      .def_readwrite("Kp", &Gain::Kp)
+      .def_readwrite("Ki", &Gain::Ki)
+      .def_readwrite("Kd", &Gain::Kd)
+      //
+      ;
+  py::class_<Breakdown>(fc, "Breakdown")
+      .def(py::init<>())
+      .def_readwrite("ff", &Breakdown::ff)
+      .def_readwrite("fb", &Breakdown::fb)
+      .def_readwrite("fbp", &Breakdown::fbp)
+      .def_readwrite("fbi", &Breakdown::fbi)
+      .def_readwrite("fbd", &Breakdown::fbd)
+      .def_readwrite("u", &Breakdown::u)
+      //
+      ;
+  fc.def(py::init<const Model&, const Gain&>(), py::arg("model"),
+         py::arg("gain"))
+      .def("reset", &FC::reset)
+      .def("update", &FC::update, py::arg("r"), py::arg("y"), py::arg("dr"),
+           py::arg("dy"), py::arg("Ts"))
+      .def("getErrorIntegral", &FC::getErrorIntegral)
+      .def("getModel", &FC::getModel)
+      .def("setModel", &FC::setModel)
+      .def("getGain", &FC::getGain)
+      .def("setGain", &FC::setGain)
+      .def("getBreakdown", &FC::getBreakdown)
+      //
+      ;
+}
+
+/**
+ * @brief bind ctrl::Accumulator<float, S>
+ */
+template <std::size_t S>
+void bindAccumulator(py::module_& m, const char* name) {
+  using A = ctrl::Accumulator<float, S>;
+  py::class_<A>(m, name)
+      .def(py::init<const float&>(), py::arg("value") = 0.0f)
+      .def("clear", &A::clear, py::arg("value") = 0.0f)
+      .def("push", &A::push)
+      .def("__getitem__",
+           [](const A& obj, const std::size_t index) {
+             if (index >= S) throw py::index_error();
+             return obj[index];
+           })
+      .def("average", &A::average, py::arg("n") = static_cast<int>(S))
+      .def("size", &A::size)
+      .def("__len__", &A::size)
+      //
+      ;
+}
+
+/**
+ * @brief step a first order plant y(s) = K1 / (T1 s + 1) u(s) exactly
+ */
+float stepPlant(const float y, const float u, const float K1, const float T1,
+                const float Ts) {
+  if (T1 <= 0) return K1 * u;
+  return y + (K1 * u - y) * (1 - std::exp(-Ts / T1));
+}
+
+/**
+ * @brief closed-loop rollout of trajectory, tracker, controller and plant
+ * @details the plant is the first order model of the controller (or the
+ * given plant model) for both translation and rotation, and the pose is
+ * integrated with unicycle kinematics.
+ * @param[in] reference function f(State&, i, t) giving the reference at
+ * step i, time t = t_start + i * Ts; the state is kept between the calls
+ * @return dict of arrays: t (n,), ref (n, 4, 3), est_q (n, 3), est_v (n, 2),
+ * est_a (n, 2), tracker (n, 4) of (v, w, dv, dw), u (n, 2),
+ * breakdown (n, 6, 2) of (ff, fb, fbp, fbi, fbd, u)
+ */
+template <typename F>
+py::dict closedLoopRollout(
+    F&& reference, const ctrl::TrajectoryTracker::Gain& tracker_gain,
+    const ctrl::FeedbackController<ctrl::Polar>::Model& model,
+    const ctrl::FeedbackController<ctrl::Polar>::Gain& gain, const float Ts,
+    const py::ssize_t n, const float t_start,
+    const std::optional<ctrl::FeedbackController<ctrl::Polar>::Model>&
+        plant_model) {
+  using namespace ctrl;
+  using Breakdown = FeedbackController<Polar>::Breakdown;
+  static_assert(sizeof(Pose) == 3 * sizeof(float), "Pose must be packed");
+  static_assert(sizeof(Polar) == 2 * sizeof(float), "Polar must be packed");
+  static_assert(sizeof(TrajectoryTracker::Result) == 4 * sizeof(float),
+                "Result must be packed");
+  static_assert(sizeof(Breakdown) == 6 * sizeof(Polar),
+                "Breakdown must be packed");
+  using Shape = std::vector<py::ssize_t>;
+  FloatArray t(n), ref(Shape{n, 4, 3}), est_q(Shape{n, 3}), est_v(Shape{n, 2}),
+      est_a(Shape{n, 2}), tracker(Shape{n, 4}), u(Shape{n, 2}),
+      breakdown(Shape{n, 6, 2});
+  float* pt = t.mutable_data();
+  auto* p_ref = reinterpret_cast<State*>(ref.mutable_data());
+  auto* p_q = reinterpret_cast<Pose*>(est_q.mutable_data());
+  auto* p_v = reinterpret_cast<Polar*>(est_v.mutable_data());
+  auto* p_a = reinterpret_cast<Polar*>(est_a.mutable_data());
+  auto* p_tt = reinterpret_cast<TrajectoryTracker::Result*>(
+      tracker.mutable_data());
+  auto* p_u = reinterpret_cast<Polar*>(u.mutable_data());
+  auto* p_bd = reinterpret_cast<Breakdown*>(breakdown.mutable_data());
+  {
+    py::gil_scoped_release release;
+    const auto plant = plant_model.value_or(model);
+    TrajectoryTracker tt(tracker_gain);
+    FeedbackController<Polar> fc(model, gain);
+    State s;
+    Pose q;
+    Polar v, a;
+    for (py::ssize_t i = 0; i < n; ++i) {
+      const float ti = t_start + i * Ts;
+      reference(s, i, ti);
+      if (i == 0) {
+        /* start on the reference */
+        q = s.q;
+        v = Polar(s.dq.x * std::cos(s.q.th) + s.dq.y * std::sin(s.q.th),
+                  s.dq.th);
+        tt.reset(v.tra);
+        fc.reset();
+      }
+      const auto res = tt.update(q, v, a, s, Ts);
+      const auto ui = fc.update({res.v, res.w}, v, {res.dv, res.dw}, a, Ts);
+      pt[i] = ti;
+      p_ref[i] = s;
+      p_q[i] = q;
+      p_v[i] = v;
+      p_a[i] = a;
+      p_tt[i] = res;
+      p_u[i] = ui;
+      p_bd[i] = fc.getBreakdown();
+      /* plant */
+      const Polar v_next(stepPlant(v.tra, ui.tra, plant.K1.tra, plant.T1.tra, Ts),
+                         stepPlant(v.rot, ui.rot, plant.K1.rot, plant.T1.rot, Ts));
+      a = (v_next - v) / Ts;
+      const float th_mid = q.th + v_next.rot * Ts / 2;
+      q.x += v_next.tra * std::cos(th_mid) * Ts;
+      q.y += v_next.tra * std::sin(th_mid) * Ts;
+      q.th += v_next.rot * Ts;
+      v = v_next;
+    }
+  }
+  py::dict d;
+  d["t"] = t;
+  d["ref"] = ref;
+  d["est_q"] = est_q;
+  d["est_v"] = est_v;
+  d["est_a"] = est_a;
+  d["tracker"] = tracker;
+  d["u"] = u;
+  d["breakdown"] = breakdown;
+  return d;
+}
 
 PYBIND11_MODULE(ctrl, m) {
-  namespace py = pybind11;
   using namespace ctrl;
 
   m.doc() = "MicroMouse Control Module";
@@ -22,7 +475,9 @@ PYBIND11_MODULE(ctrl, m) {
   py::class_<AccelCurve>(m, "AccelCurve")
       .def(py::init<>())
       .def(py::init<float, float, float, float>())
-      .def("reset", &AccelCurve::reset)
+      /* overload_cast cannot deduce with the template reset(L, ...) overload */
+      .def("reset", static_cast<void (AccelCurve::*)(float, float, float, float)>(
+                        &AccelCurve::reset))
       .def("j", &AccelCurve::j)
       .def("a", &AccelCurve::a)
       .def("v", &AccelCurve::v)
@@ -35,6 +490,7 @@ PYBIND11_MODULE(ctrl, m) {
       .def("t_2", &AccelCurve::t_2)
       .def("t_3", &AccelCurve::t_3)
       .def("getTimeStamps", &AccelCurve::getTimeStamps)
+      .def("sample", &sample<AccelCurve>, py::arg("t"))
       .def("__str__",
            [](const AccelCurve& obj) {
              std::stringstream ss;
@@ -50,7 +506,9 @@ PYBIND11_MODULE(ctrl, m) {
            py::arg("j_max"), py::arg("a_max"), py::arg("v_max"),
            py::arg("v_start"), py::arg("v_target"), py::arg("dist"),
            py::arg("x_start") = 0.0f, py::arg("t_start") = 0.0f)
-      .def("reset", &AccelDesigner::reset,  //
+      .def("reset",
+           py::overload_cast<float, float, float, float, float, float, float,
+                             float>(&AccelDesigner::reset),
            py::arg("j_max"), py::arg("a_max"), py::arg("v_max"),
            py::arg("v_start"), py::arg("v_target"), py::arg("dist"),
            py::arg("x_start") = 0.0f, py::arg("t_start") = 0.0f)
@@ -66,6 +524,7 @@ PYBIND11_MODULE(ctrl, m) {
       .def("t_2", &AccelDesigner::t_2)
       .def("t_3", &AccelDesigner::t_3)
       .def("getTimeStamps", &AccelDesigner::getTimeStamps)
+      .def("sample", &sample<AccelDesigner>, py::arg("t"))
       .def("__str__",
            [](const AccelDesigner& obj) {
              std::stringstream ss;
@@ -83,8 +542,9 @@ PYBIND11_MODULE(ctrl, m) {
       .def_readwrite("th", &Pose::th)
       .def("clear", &Pose::clear)
       .def("mirror_x", &Pose::mirror_x)
-      .def("rotate", &Pose::rotate)
+      .def("rotate", py::overload_cast<float>(&Pose::rotate, py::const_))
       .def("homogeneous", &Pose::homogeneous)
+      .def("arc", &Pose::arc, py::arg("ds"), py::arg("dth"))
       .def(py::self += py::self)
       .def(py::self -= py::self)  // cppcheck-suppress duplicateExpression
       .def(py::self + py::self)
@@ -98,6 +558,29 @@ PYBIND11_MODULE(ctrl, m) {
       //
       ;
 
+  py::class_<Polar>(m, "Polar")
+      .def(py::init<>())
+      .def(py::init<float, float>(), py::arg("tra"), py::arg("rot"))
+      .def_readwrite("tra", &Polar::tra)
+      .def_readwrite("rot", &Polar::rot)
+      .def("clear", &Polar::clear)
+      .def(py::self += py::self)
+      .def(py::self -= py::self)  // cppcheck-suppress duplicateExpression
+      .def(py::self + py::self)
+      .def(py::self - py::self)
+      .def(py::self * py::self)
+      .def(py::self / py::self)
+      .def(py::self * float())
+      .def(py::self / float())
+      .def("__str__",
+           [](const Polar& obj) {
+             std::stringstream ss;
+             ss << obj;
+             return ss.str();
+           })
+      //
+      ;
+
   py::class_<slalom::Shape>(m, "Shape")
       .def(py::init<Pose, float, float, float, float, float>(),
            py::arg("total"), py::arg("y_curve_end"), py::arg("x_adv") = 0,
@@ -123,6 +606,10 @@ PYBIND11_MODULE(ctrl, m) {
       //
       ;
 
+  m.def("build_shapes", &buildShapes, py::arg("params"),
+        py::arg("threads") = 0, py::arg("as_array") = false,
+        "build slalom shapes in parallel with the GIL released");
+
   py::class_<State>(m, "State")
       .def(py::init<>())
       .def_readwrite("q", &State::q)
@@ -132,16 +619,132 @@ PYBIND11_MODULE(ctrl, m) {
       //
       ;
 
+  PYBIND11_NUMPY_DTYPE(Pose, x, y, th);
+  PYBIND11_NUMPY_DTYPE(State, q, dq, ddq, dddq);
+  bindArray<Pose>(m, "PoseArray");
+  bindArray<State>(m, "StateArray");
+
+  py::class_<straight::Trajectory, AccelDesigner>(m, "StraightTrajectory")
+      .def(py::init<>())
+      .def("update", &straight::Trajectory::update, py::arg("state"),
+           py::arg("t"))
+      .def("rollout_into",
+           py::overload_cast<const straight::Trajectory&, StateArray&, float, float>(
+               &rolloutInto<State>),
+           py::arg("out"), py::arg("Ts"), py::arg("t_start") = 0e0f)
+      .def("rollout_into",
+           py::overload_cast<const straight::Trajectory&, PoseArray&, float, float>(
+               &rolloutInto<Pose>),
+           py::arg("out"), py::arg("Ts"), py::arg("t_start") = 0e0f)
+      //
+      ;
+
   py::class_<slalom::Trajectory>(m, "Trajectory")
       .def(py::init<slalom::Shape&, bool>(), py::arg("shape"),
            py::arg("mirror_x") = false)
       .def("reset", &slalom::Trajectory::reset)
       .def("update", &slalom::Trajectory::update, py::arg("state"),
            py::arg("t"), py::arg("Ts"), py::arg("k_slip") = 0e0f)
+      .def("rollout", &rollout, py::arg("Ts"), py::arg("n"),
+           py::arg("t_start") = 0e0f, py::arg("k_slip") = 0e0f)
+      .def("rollout_into",
+           py::overload_cast<const slalom::Trajectory&, StateArray&, float,
+                             float, float>(&rolloutInto<State>),
+           py::arg("out"), py::arg("Ts"), py::arg("t_start") = 0e0f,
+           py::arg("k_slip") = 0e0f)
+      .def("rollout_into",
+           py::overload_cast<const slalom::Trajectory&, PoseArray&, float,
+                             float, float>(&rolloutInto<Pose>),
+           py::arg("out"), py::arg("Ts"), py::arg("t_start") = 0e0f,
+           py::arg("k_slip") = 0e0f)
       .def("getVelocity", &slalom::Trajectory::getVelocity)
       .def("getTimeCurve", &slalom::Trajectory::getTimeCurve)
       .def("getShape", &slalom::Trajectory::getShape)
       .def("getAccelDesigner", &slalom::Trajectory::getAccelDesigner)
       //
       ;
+
+  py::class_<TrajectoryTracker> tt(m, "TrajectoryTracker");
+  py::class_<TrajectoryTracker::Gain>(tt, "Gain")
+      .def(py::init<>())
+      .def_readwrite("zeta", &TrajectoryTracker::Gain::zeta)
+      .def_readwrite("omega_n", &TrajectoryTracker::Gain::omega_n)
+      .def_readwrite("low_zeta", &TrajectoryTracker::Gain::low_zeta)
+      .def_readwrite("low_b", &TrajectoryTracker::Gain::low_b)
+      //
+      ;
+  py::class_<TrajectoryTracker::Result>(tt, "Result")
+      .def(py::init<>())
+      .def_readwrite("v", &TrajectoryTracker::Result::v)
+      .def_readwrite("w", &TrajectoryTracker::Result::w)
+      .def_readwrite("dv", &TrajectoryTracker::Result::dv)
+      .def_readwrite("dw", &TrajectoryTracker::Result::dw)
+      //
+      ;
+  tt.def(py::init<const TrajectoryTracker::Gain&, float>(), py::arg("gain"),
+         py::arg("xi_threshold") = TrajectoryTracker::kXiThresholdDefault)
+      .def("reset", &TrajectoryTracker::reset, py::arg("vs") = 0.0f)
+      .def("update",
+           py::overload_cast<const Pose&, const Polar&, const Polar&,
+                             const State&, float>(&TrajectoryTracker::update),
+           py::arg("est_q"), py::arg("est_v"), py::arg("est_a"),
+           py::arg("ref_s"),
+           py::arg("Ts") = TrajectoryTracker::kIntegrationPeriodDefault)
+      .def("update",
+           py::overload_cast<const Pose&, const Polar&, const Polar&,
+                             const Pose&, const Pose&, const Pose&,
+                             const Pose&, float>(&TrajectoryTracker::update),
+           py::arg("est_q"), py::arg("est_v"), py::arg("est_a"),
+           py::arg("ref_q"), py::arg("ref_dq"), py::arg("ref_ddq"),
+           py::arg("ref_dddq"),
+           py::arg("Ts") = TrajectoryTracker::kIntegrationPeriodDefault)
+      .def_static("sinc", &TrajectoryTracker::sinc)
+      //
+      ;
+
+  bindFeedbackController<float>(m, "FeedbackController");
+  bindFeedbackController<Polar>(m, "FeedbackControllerPolar");
+
+  bindAccumulator<8>(m, "Accumulator8");
+  bindAccumulator<32>(m, "Accumulator32");
+  bindAccumulator<128>(m, "Accumulator128");
+
+  using PolarModel = FeedbackController<Polar>::Model;
+  using PolarGain = FeedbackController<Polar>::Gain;
+  m.def(
+      "rollout",
+      [](const straight::Trajectory& trajectory,
+         const TrajectoryTracker::Gain& tracker_gain, const PolarModel& model,
+         const PolarGain& gain, const float Ts, const py::ssize_t n,
+         const float t_start, const std::optional<PolarModel>& plant) {
+        return closedLoopRollout(
+            [&](State& s, py::ssize_t, const float t) {
+              trajectory.update(s, t);
+            },
+            tracker_gain, model, gain, Ts, n, t_start, plant);
+      },
+      py::arg("trajectory"), py::arg("tracker_gain"), py::arg("model"),
+      py::arg("gain"), py::arg("Ts"), py::arg("n"), py::arg("t_start") = 0e0f,
+      py::arg("plant") = py::none(),
+      "closed-loop rollout along a straight trajectory");
+  m.def(
+      "rollout",
+      [](const slalom::Trajectory& trajectory,
+         const TrajectoryTracker::Gain& tracker_gain, const PolarModel& model,
+         const PolarGain& gain, const float Ts, const py::ssize_t n,
+         const float t_start, const std::optional<PolarModel>& plant) {
+        return closedLoopRollout(
+            [&](State& s, const py::ssize_t i, const float t) {
+              /* the same time base as Trajectory.rollout */
+              if (i == 0)
+                trajectory.update(s, t, 0);
+              else
+                trajectory.update(s, t_start + (i - 1) * Ts, Ts);
+            },
+            tracker_gain, model, gain, Ts, n, t_start, plant);
+      },
+      py::arg("trajectory"), py::arg("tracker_gain"), py::arg("model"),
+      py::arg("gain"), py::arg("Ts"), py::arg("n"), py::arg("t_start") = 0e0f,
+      py::arg("plant") = py::none(),
+      "closed-loop rollout along a slalom trajectory");
 }
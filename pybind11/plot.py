@@ -23,10 +23,7 @@ def plot_accel_designer():
     time_stamps = ad.getTimeStamps()
     for i in range(len(time_stamps)-1):
         t = np.arange(time_stamps[i], time_stamps[i+1], 1e-3)
-        j = np.array([ad.j(tt) for tt in t])
-        a = np.array([ad.a(tt) for tt in t])
-        v = np.array([ad.v(tt) for tt in t])
-        x = np.array([ad.x(tt) for tt in t])
+        j, a, v, x = ad.sample(t)
         for i, d in enumerate([j, a, v, x]):
             ax = axes[i]
             ax.plot(t, d, lw=4)
@@ -62,10 +59,7 @@ def plot_slalom():
     time_stamps.append(time_stamps[-1]+shape.straight_post / v)
     for i in range(len(time_stamps)-1):
         t = np.arange(time_stamps[i], time_stamps[i+1], Ts)
-        j = np.array([ad.j(tt) for tt in t])
-        a = np.array([ad.a(tt) for tt in t])
-        v = np.array([ad.v(tt) for tt in t])
-        x = np.array([ad.x(tt) for tt in t])
+        j, a, v, x = ad.sample(t)
         for i, d in enumerate([j, a, v, x]):
             ax = axes[i]
             ax.plot(t, d, lw=4)
@@ -80,16 +74,11 @@ def plot_slalom():
 
     # shape
     fig_xy, ax = plt.subplots(figsize=(6, 6))
-    state = ctrl.State()
+    n = int(np.ceil((time_stamps[-1] - time_stamps[0]) / Ts)) + 1
+    t, states = trajectory.rollout(Ts, n, time_stamps[0])
     for i in range(len(time_stamps)-1):
-        t = np.arange(time_stamps[i], time_stamps[i+1], Ts)
-        x = []
-        y = []
-        for tt in t:
-            trajectory.update(state, tt, Ts)
-            x.append(state.q.x)
-            y.append(state.q.y)
-        ax.plot(x, y, lw=4)
+        k = (time_stamps[i] <= t) & (t <= time_stamps[i+1])
+        ax.plot(states[k, 0, 0], states[k, 0, 1], lw=4)
 
     ax.set_title('Slalom Shape')
     ax.set_xlabel('x [mm]')
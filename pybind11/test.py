@@ -1,15 +1,238 @@
 #!/usr/bin/env python
 # -*- coding: utf-8 -*-
 # ============================================================================ #
+# Checks and timings of the ctrl module.
+#
+# usage: python test.py        # run the checks and print the timings
+#        python test.py plot   # show the plots of AccelCurve and AccelDesigner
+# ============================================================================ #
 import math
+import os
+import sys
+import time
+
 import numpy as np
-import matplotlib.pyplot as plt
-from matplotlib.ticker import ScalarFormatter
 
 import ctrl  # calls $PYTHONPATH/ctrl.so
 
 
+def best_time(f, repeat=3):
+    # the best of some runs [s]
+    best = math.inf
+    for _ in range(repeat):
+        ts = time.perf_counter()
+        f()
+        best = min(best, time.perf_counter() - ts)
+    return best
+
+
+def report(name, sec):
+    print('[time] {:<48s} {:10.3f} ms'.format(name, sec * 1e3))
+
+
+def straight_trajectory():
+    tr = ctrl.StraightTrajectory()
+    tr.reset(j_max=240000, a_max=9000, v_max=2400, v_start=0, v_target=0,
+             dist=1800)
+    return tr
+
+
+def slalom_trajectory():
+    shape = ctrl.Shape(total=ctrl.Pose(90, 90, math.pi / 2), y_curve_end=70)
+    tr = ctrl.Trajectory(shape)
+    tr.reset(shape.v_ref, 0, 0)
+    return tr
+
+
+def check_sample():
+    ad = ctrl.AccelDesigner(j_max=240000, a_max=9000, v_max=2400,
+                            v_start=0, v_target=0, dist=1800)
+    n = 1000000
+    t = np.linspace(ad.t_0(), ad.t_end(), n, dtype=np.float32)
+    j, a, v, x = ad.sample(t)
+    assert j.shape == t.shape and x.dtype == np.float32
+    # the same as the per-point methods
+    for i in range(0, n, 9973):
+        ti = float(t[i])
+        assert np.float32(ad.j(ti)) == j[i]
+        assert np.float32(ad.a(ti)) == a[i]
+        assert np.float32(ad.v(ti)) == v[i]
+        assert np.float32(ad.x(ti)) == x[i]
+    # other shapes and dtypes are accepted
+    j2, _, _, _ = ad.sample(t.astype(np.float64).reshape(1000, 1000))
+    assert j2.shape == (1000, 1000) and np.array_equal(j2.ravel(), j)
+    # timing against a loop over the per-point methods
+    m = 10000
+    report('AccelDesigner.sample, 1e6 points', best_time(lambda: ad.sample(t)))
+    tl = t[:m].tolist()
+    sec = best_time(lambda: [(ad.j(ti), ad.a(ti), ad.v(ti), ad.x(ti))
+                             for ti in tl])
+    report('per-point j, a, v, x loop, 1e6 points (from 1e4)', sec * n / m)
+
+
+def check_slalom_rollout():
+    tr = slalom_trajectory()
+    Ts = 1e-4
+    n = int(tr.getTimeCurve() / Ts) + 1
+    t, states = tr.rollout(Ts, n)
+    assert t.shape == (n,) and states.shape == (n, 4, 3)
+    # states[i] is at t[i] = i * Ts, starting at the origin
+    assert np.allclose(t, np.arange(n) * Ts)
+    assert np.all(states[0, 0] == 0)
+    assert abs(states[0, 1, 0] - tr.getVelocity()) < 1e-3
+    # the same as update() from the start, up to rounding
+    s = ctrl.State()
+    for i in range(1, n):
+        tr.update(s, (i - 1) * Ts, Ts)
+    assert abs(states[-1, 0, 0] - s.q.x) < 1e-2
+    assert abs(states[-1, 0, 1] - s.q.y) < 1e-2
+    assert abs(states[-1, 0, 2] - s.q.th) < 1e-5
+    # zero-copy arrays
+    sa = ctrl.StateArray(n)
+    tr.rollout_into(sa, Ts)
+    sv = np.asarray(sa)
+    assert sv.shape == (n,) and sv.dtype.names == ('q', 'dq', 'ddq', 'dddq')
+    assert np.array_equal(sv['q']['x'], states[:, 0, 0])
+    assert np.array_equal(sv['dq']['th'], states[:, 1, 2])
+    sa[0] = ctrl.State()
+    assert sv['q']['x'][0] == 0  # the view shares the storage
+    pa = ctrl.PoseArray(n)
+    tr.rollout_into(pa, Ts)
+    pv = np.asarray(pa)
+    assert np.allclose(pv['x'], states[:, 0, 0], atol=1e-2)
+    report('Trajectory.rollout, {} steps'.format(n),
+           best_time(lambda: tr.rollout(Ts, n)))
+
+    def loop():
+        s = ctrl.State()
+        for i in range(1, n):
+            tr.update(s, (i - 1) * Ts, Ts)
+    report('Trajectory.update loop, {} steps'.format(n), best_time(loop))
+
+
+def check_build_shapes():
+    params = [dict(total=(90, 90, math.pi / 2), y_curve_end=y)
+              for y in np.linspace(60, 80, 1000)]
+    shapes = ctrl.build_shapes(params, threads=1)
+    assert len(shapes) == len(params)
+    for i in range(0, len(params), 97):
+        ref = ctrl.Shape(total=ctrl.Pose(90, 90, math.pi / 2),
+                         y_curve_end=float(params[i]['y_curve_end']))
+        assert shapes[i].v_ref == ref.v_ref
+        assert shapes[i].curve.x == ref.curve.x
+        assert shapes[i].straight_post == ref.straight_post
+    arr = ctrl.build_shapes(params, as_array=True)
+    assert arr.shape == (len(params),)
+    assert arr['v_ref'][10] == np.float32(shapes[10].v_ref)
+    assert arr['curve.y'][20] == np.float32(shapes[20].curve.y)
+    # tuples are accepted as well
+    t = ctrl.build_shapes([((90, 90, math.pi / 2), 70)])[0]
+    assert t.v_ref == ctrl.Shape(total=ctrl.Pose(90, 90, math.pi / 2),
+                                 y_curve_end=70).v_ref
+    report('Shape loop, 1000 shapes',
+           best_time(lambda: [ctrl.Shape(total=ctrl.Pose(*p['total']),
+                                         y_curve_end=float(p['y_curve_end']))
+                              for p in params], repeat=1))
+    n_cpu = os.cpu_count() or 1
+    for threads in sorted({1, 2, 4, n_cpu}):
+        report('build_shapes, 1000 shapes, {} threads'.format(threads),
+               best_time(lambda: ctrl.build_shapes(params, threads=threads),
+                         repeat=1))
+
+
+def closed_loop_python(tr, tracker_gain, model, gain, Ts, n):
+    # the same loop as ctrl.rollout() written with the bound classes
+    tt = ctrl.TrajectoryTracker(tracker_gain)
+    fc = ctrl.FeedbackControllerPolar(model, gain)
+    s = ctrl.State()
+    x = y = th = 0.0
+    v = ctrl.Polar(0, 0)
+    a = ctrl.Polar(0, 0)
+    out = np.empty((n, 3), dtype=np.float32)
+    for i in range(n):
+        tr.update(s, i * Ts)
+        if i == 0:
+            x, y, th = s.q.x, s.q.y, s.q.th
+            v = ctrl.Polar(s.dq.x * math.cos(th) + s.dq.y * math.sin(th),
+                           s.dq.th)
+            tt.reset(v.tra)
+            fc.reset()
+        q = ctrl.Pose(x, y, th)
+        res = tt.update(q, v, a, s, Ts)
+        u = fc.update(ctrl.Polar(res.v, res.w), v, ctrl.Polar(res.dv, res.dw),
+                      a, Ts)
+        out[i] = (x, y, th)
+        k_tra = 1 - math.exp(-Ts / model.T1.tra)
+        k_rot = 1 - math.exp(-Ts / model.T1.rot)
+        v_next = ctrl.Polar(v.tra + (model.K1.tra * u.tra - v.tra) * k_tra,
+                            v.rot + (model.K1.rot * u.rot - v.rot) * k_rot)
+        a = ctrl.Polar((v_next.tra - v.tra) / Ts, (v_next.rot - v.rot) / Ts)
+        th_mid = th + v_next.rot * Ts / 2
+        x += v_next.tra * math.cos(th_mid) * Ts
+        y += v_next.tra * math.sin(th_mid) * Ts
+        th += v_next.rot * Ts
+        v = v_next
+    return out
+
+
+def check_closed_loop():
+    tracker_gain = ctrl.TrajectoryTracker.Gain()
+    model = ctrl.FeedbackControllerPolar.Model(
+        K1=ctrl.Polar(1, 1), T1=ctrl.Polar(0.05, 0.05))
+    gain = ctrl.FeedbackControllerPolar.Gain(
+        Kp=ctrl.Polar(0.5, 0.5), Ki=ctrl.Polar(0, 0), Kd=ctrl.Polar(0, 0))
+    Ts = 1e-3
+    # straight
+    tr = straight_trajectory()
+    n = int(tr.t_end() / Ts) + 100
+    res = ctrl.rollout(tr, tracker_gain, model, gain, Ts=Ts, n=n)
+    for key, shape in [('t', (n,)), ('ref', (n, 4, 3)), ('est_q', (n, 3)),
+                       ('est_v', (n, 2)), ('est_a', (n, 2)),
+                       ('tracker', (n, 4)), ('u', (n, 2)),
+                       ('breakdown', (n, 6, 2))]:
+        assert res[key].shape == shape, key
+    assert abs(res['est_q'][-1, 0] - 1800) < 2
+    q = closed_loop_python(tr, tracker_gain, model, gain, Ts, n)
+    assert np.allclose(q, res['est_q'], atol=1)
+    sec_c = best_time(lambda: ctrl.rollout(tr, tracker_gain, model, gain,
+                                           Ts=Ts, n=n))
+    sec_py = best_time(lambda: closed_loop_python(tr, tracker_gain, model,
+                                                  gain, Ts, n), repeat=1)
+    report('rollout, straight, {} ticks'.format(n), sec_c)
+    report('Python loop, straight, {} ticks'.format(n), sec_py)
+    print('[time] speedup: {:.0f}x'.format(sec_py / sec_c))
+    # slalom: the reference starts at the origin at t_start
+    tr = slalom_trajectory()
+    n = int(tr.getTimeCurve() / Ts) + 1
+    t_start = 0.01
+    tr.reset(tr.getVelocity(), 0, t_start)
+    res = ctrl.rollout(tr, tracker_gain, model, gain, Ts=Ts, n=n,
+                       t_start=t_start)
+    assert np.all(res['ref'][0, 0] == 0)
+    assert abs(res['ref'][0, 1, 0] - tr.getVelocity()) < 1e-3
+    assert abs(res['t'][0] - t_start) < 1e-7
+    _, states = tr.rollout(Ts, n, t_start)
+    assert np.allclose(res['ref'][:, 0], states[:, 0], atol=1e-2)
+    s = ctrl.State()
+    for i in range(1, n):
+        tr.update(s, t_start + (i - 1) * Ts, Ts)
+    assert abs(res['ref'][-1, 0, 0] - s.q.x) < 1e-2
+    assert abs(res['ref'][-1, 0, 2] - s.q.th) < 1e-5
+
+
+def check_accumulator():
+    acc = ctrl.Accumulator8(1)
+    for i in range(8):
+        acc.push(i)
+    assert acc[0] == 7 and acc[7] == 0
+    assert acc.average() == 3.5
+    assert acc.average(2) == 6.5
+    assert len(acc) == 8
+
+
 def plot_accel_designer(ad):
+    import matplotlib.pyplot as plt
+    from matplotlib.ticker import ScalarFormatter
     # visualize j, a, v, x
     fig, axes = plt.subplots(4, 1, figsize=(6, 8))
     titles = ['Jerk', 'Acceleration', 'Velocity', 'Position']
@@ -19,10 +242,7 @@ def plot_accel_designer(ad):
     dt = (time_stamps[-1] - time_stamps[0]) * 1e-4
     for i in range(len(time_stamps)-1):
         t = np.arange(time_stamps[i]+dt, time_stamps[i+1], dt)
-        j = np.array([ad.j(tt) for tt in t])
-        a = np.array([ad.a(tt) for tt in t])
-        v = np.array([ad.v(tt) for tt in t])
-        x = np.array([ad.x(tt) for tt in t])
+        j, a, v, x = ad.sample(t)
         for i, d in enumerate([j, a, v, x]):
             ax = axes[i]
             ax.plot(t, d, lw=4)
@@ -74,9 +294,13 @@ def test_accel_designer():
 
 
 if __name__ == "__main__":
-    # test_accel_curve()
-    # test_accel_designer()
-    plot_accel_designer(ctrl.AccelCurve(100, 6, 0, 1))
-    # plt.savefig('accel_curve.pdf')
-    plot_accel_designer(ctrl.AccelDesigner(100, 6, 2, 0, 1, 1))
-    # plt.savefig('accel_designer.pdf')
+    if len(sys.argv) > 1 and sys.argv[1] == 'plot':
+        plot_accel_designer(ctrl.AccelCurve(100, 6, 0, 1))
+        plot_accel_designer(ctrl.AccelDesigner(100, 6, 2, 0, 1, 1))
+        sys.exit(0)
+    check_sample()
+    check_slalom_rollout()
+    check_build_shapes()
+    check_closed_loop()
+    check_accumulator()
+    print('OK')
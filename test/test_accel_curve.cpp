@@ -8,6 +8,7 @@
 #include <ctrl/accel_curve.h>
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <random>
 
 using namespace ctrl;
@@ -78,3 +79,34 @@ TEST(AccelCurve, GivenConstraints) {
     act.test(ps[0], ps[1], -ps[2], -ps[3]);
   }
 }
+
+TEST(AccelCurve, ReachableVelocityCubic) {
+  /* reference: bisection of (u + a)^2 (u - a) = b for the largest root */
+  const auto solve = [](const double a, const double b) {
+    const auto g = [a, b](double u) { return (u + a) * (u + a) * (u - a) - b; };
+    double lo = -a - std::cbrt(std::abs(b)) - 1;
+    double hi = a + std::cbrt(std::abs(b)) + 1;
+    if (b < 0 && -b <= 32 * a * a * a / 27) lo = a / 3;
+    for (int i = 0; i < 200; ++i) {
+      const auto u = (lo + hi) / 2;
+      (g(u) < 0 ? lo : hi) = u;
+    }
+    return (lo + hi) / 2;
+  };
+  std::mt19937 mt{std::random_device{}()};
+  std::uniform_real_distribution<float> e_urd(-3, 3);
+  for (int i = 0; i < 10000; ++i) {
+    const float a = i % 16 == 0 ? 0 : std::pow(10.0f, e_urd(mt));
+    const float b = (i % 2 ? 1 : -1) * std::pow(10.0f, 3 * e_urd(mt));
+    float error;
+    const auto u = AccelCurve::solveReachableVelocityCubic(a, b, &error);
+    const auto u_ref = solve(a, b);
+    EXPECT_LE(std::abs(u - u_ref), error) << "a: " << a << "\tb: " << b;
+    EXPECT_LE(error, 1e-3 * std::max(std::abs(u_ref), double(a)))
+        << "a: " << a << "\tb: " << b;
+  }
+  /* boundary */
+  EXPECT_EQ(AccelCurve::solveReachableVelocityCubic(0, 0), 0);
+  EXPECT_FLOAT_EQ(AccelCurve::solveReachableVelocityCubic(1, 0), 1);
+  EXPECT_FLOAT_EQ(AccelCurve::solveReachableVelocityCubic(3, -32), 1);
+}
@@ -8,7 +8,11 @@
 #include <ctrl/accel_designer.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <random>
+#include <type_traits>
 
 using namespace ctrl;
 
@@ -31,9 +35,16 @@ class AccelDesignerTest : public AccelDesigner {
       EXPECT_LE(std::abs(v(t)), std::max({vm, std::abs(vs), std::abs(vt)}));
     /* distance */
     EXPECT_NEAR(d, x3 - x0, std::abs(d) * e);
-    EXPECT_NEAR(x(t0), xs, std::abs(xs) * e * 1e3f);
+    /* a cruise time clamped to zero leaves a step of the rounding error */
+    EXPECT_NEAR(x(t0), xs, std::abs(xs) * e * 1e3f + std::abs(d) * e);
     EXPECT_NEAR(x(t3), xs + d, std::abs(xs + d) * e * 1e3f);
   }
+  int path(const float jm, const float am, const float vm, const float vs,
+           const float vt, const float d) {
+    int p = -1;
+    design(AccelLimits(jm, am), vm, vs, vt, d, 0, 0, &p);
+    return p;
+  }
 };
 
 TEST(AccelDesigner, RandomConstraints) {
@@ -81,3 +92,158 @@ TEST(AccelDesigner, GivenConstraints) {
     ad.test(ps[0], ps[1], ps[2], -ps[3], -ps[4], -ps[5], 0, 0);
   }
 }
+
+TEST(AccelDesigner, Path) {
+  /* the reported path agrees with the designed curve */
+  AccelDesignerTest ad;
+  std::array<int, 8> count{};
+  for (const float vm : {2.0f, 4.0f, 8.0f})
+    for (int i = 0; i <= 8; ++i)
+      for (int k = 0; k <= 8; ++k)
+        for (int l = 0; l <= 12; ++l)
+          for (const float sign : {1.0f, -1.0f}) {
+            const float vs = sign * vm * i / 8;
+            const float vt = sign * vm * k / 8;
+            const float d = sign * 1e-3f * std::pow(10.0f, l / 3.0f);
+            const auto p = ad.path(100, 10, vm, vs, vt, d);
+            ASSERT_GE(p, 0);
+            ASSERT_LT(p, 8);
+            ++count[p];
+            const AccelDesigner ref(100, 10, vm, vs, vt, d);
+            EXPECT_EQ(ad.t_end(), ref.t_end());
+            /* the target velocity is reached unless v_end was solved */
+            if ((p & 3) == 0) {
+              EXPECT_EQ(ad.v_end(), vt);
+            } else {
+              EXPECT_NE(ad.v_end(), vt);
+            }
+            /* the saturation velocity is below v_max if v_rm was solved,
+             * unless it is clipped to the start or end velocity */
+            const auto v_sat = ad.v(ad.t_1());
+            if (p & 4) {
+              EXPECT_TRUE(std::abs(v_sat) < vm || v_sat == vs ||
+                          v_sat == ad.v_end());
+            }
+          }
+  /* every branch is covered */
+  EXPECT_GT(count[0], 0);
+  EXPECT_GT(count[4], 0);
+  for (int b = 1; b < 4; ++b) EXPECT_GT(count[b] + count[b | 4], 0) << b;
+}
+
+TEST(AccelDesigner, Branchless) {
+  const std::vector<std::vector<float>> params = {
+      // jm, am, vm, vs, vt, d
+      {100, 10, 4, 0, 0, 0},      //< 0
+      {100, 10, 4, 0, 2, 4},      //< vs -> vm -> vt, tm1>0, tm2>0
+      {100, 10, 4, 3, 0, 4},      //< vs -> vm -> vt, tm1<0, tm2>0
+      {100, 10, 8, 0, 0.5, 0.2},  //< vs -> vr -> vt, vr<vm, tm1<0, tm2<0
+      {100, 10, 8, 4, 0, 1},      //< ve != vt, tm > 0, decel
+      {100, 10, 4, 0, 4, 0.1},    //< ve != vt, tm < 0, accel
+  };
+  for (const auto& ps : params) {
+    for (const float sign : {1.0f, -1.0f}) {
+      const AccelDesigner ad(ps[0], ps[1], ps[2], sign * ps[3], sign * ps[4],
+                             sign * ps[5], 1, 2);
+      /* boundaries and their neighbors, then a uniform grid */
+      std::vector<float> ts;
+      for (const auto t : ad.getTimeStamps())
+        for (const auto dir : {-1.0f, 1.0f})
+          ts.push_back(std::nextafter(t, t + dir)), ts.push_back(t);
+      const float Ts = (ad.t_end() - ad.t_0() + 1) / 1000;
+      for (int i = -100; i < 1100; ++i) ts.push_back(ad.t_0() + i * Ts);
+      for (const auto t : ts) {
+        EXPECT_EQ(ad.jBranchless(t), ad.jBranching(t)) << t;
+        EXPECT_EQ(ad.aBranchless(t), ad.aBranching(t)) << t;
+        EXPECT_EQ(ad.vBranchless(t), ad.vBranching(t)) << t;
+        EXPECT_EQ(ad.xBranchless(t), ad.xBranching(t)) << t;
+        /* j() and the others take the path selected at compile time */
+        const bool branchless = CTRL_ACCEL_CURVE_BRANCHLESS;
+        EXPECT_EQ(ad.j(t), branchless ? ad.jBranchless(t) : ad.jBranching(t));
+        EXPECT_EQ(ad.x(t), branchless ? ad.xBranchless(t) : ad.xBranching(t));
+      }
+    }
+  }
+}
+
+TEST(AccelDesigner, Walker) {
+  const std::vector<std::vector<float>> params = {
+      // jm, am, vm, vs, vt, d
+      {100, 10, 4, 0, 0, 0},      //< 0
+      {100, 10, 4, 0, 2, 4},      //< vs -> vm -> vt, tm1>0, tm2>0
+      {100, 10, 4, 3, 0, 4},      //< vs -> vm -> vt, tm1<0, tm2>0
+      {100, 10, 8, 0, 0.5, 0.2},  //< vs -> vr -> vt, vr<vm, tm1<0, tm2<0
+      {100, 10, 8, 4, 0, 1},      //< ve != vt, tm > 0, decel
+      {100, 10, 4, 0, 4, 0.1},    //< ve != vt, tm < 0, accel
+  };
+  for (const auto& ps : params) {
+    for (const float sign : {1.0f, -1.0f}) {
+      const AccelDesigner ad(ps[0], ps[1], ps[2], sign * ps[3], sign * ps[4],
+                             sign * ps[5], 1, 2);
+      /* ascending times across every boundary, before and after the curve */
+      std::vector<float> ts;
+      const float Ts = (ad.t_end() - ad.t_0() + 1) / 1000;
+      for (int i = -100; i < 1100; ++i) ts.push_back(ad.t_0() + i * Ts);
+      const auto stamps = ad.getTimeStamps();
+      ts.insert(ts.end(), stamps.begin(), stamps.end());
+      std::sort(ts.begin(), ts.end());
+      AccelDesigner::Walker w(ad);
+      /* same up to rounding */
+      const float e = 1e-5f;
+      const float vmax = std::max({ps[2], ps[3], ps[4]});
+      for (const auto t : ts) {
+        EXPECT_NEAR(w.a(t), ad.a(t), e * ps[1]) << t;
+        EXPECT_NEAR(w.v(t), ad.v(t), e * vmax) << t;
+        EXPECT_NEAR(w.x(t), ad.x(t), e * (1 + std::abs(ps[5]))) << t;
+        /* jerk is discontinuous at the boundaries */
+        if (std::find(stamps.begin(), stamps.end(), t) == stamps.end()) {
+          EXPECT_EQ(w.j(t), ad.j(t)) << t;
+        }
+      }
+    }
+  }
+}
+
+struct FixedLimits {
+  static constexpr float j_max = 240000;
+  static constexpr float a_max = 6000;
+};
+
+TEST(AccelDesigner, Fixed) {
+  std::mt19937 mt{std::random_device{}()};
+  std::uniform_real_distribution<float> v_urd(0, 3000);
+  std::uniform_real_distribution<float> x_urd(1, 3000);
+  for (int i = 0; i < 1000; ++i) {
+    const float sign = i % 2 ? 1 : -1;
+    const float vm = v_urd(mt) + 100;
+    const float vs = sign * v_urd(mt), vt = sign * v_urd(mt);
+    const float d = sign * x_urd(mt);
+    const AccelDesigner ad(FixedLimits::j_max, FixedLimits::a_max, vm, vs, vt,
+                           d);
+    const AccelDesignerFixed<FixedLimits> adf(vm, vs, vt, d);
+    /* same up to rounding of the reciprocal */
+    const float e = 1e-4f;
+    const auto vmax = std::max({vm, std::abs(vs), std::abs(vt)});
+    for (const auto& [t, tf] : {std::make_pair(ad.t_0(), adf.t_0()),
+                                std::make_pair(ad.t_1(), adf.t_1()),
+                                std::make_pair(ad.t_2(), adf.t_2()),
+                                std::make_pair(ad.t_3(), adf.t_3())})
+      EXPECT_NEAR(t, tf, e * std::max(1.0f, ad.t_end()));
+    EXPECT_NEAR(ad.v_end(), adf.v_end(), e * vmax);
+    EXPECT_NEAR(ad.v(ad.t_1()), adf.v(adf.t_1()), e * vmax);
+    EXPECT_NEAR(ad.x_end(), adf.x_end(), e * std::abs(d));
+  }
+}
+
+TEST(AccelDesigner, FixedNotConvertible) {
+  /* the runtime-limit reset() must not be reachable from a fixed designer */
+  static_assert(!std::is_convertible<AccelDesignerFixed<FixedLimits>*,
+                                     AccelDesigner*>::value,
+                "AccelDesignerFixed must not convert to AccelDesigner");
+  static_assert(std::is_convertible<AccelDesignerFixed<FixedLimits>*,
+                                    BasicAccelDesigner*>::value,
+                "AccelDesignerFixed must convert to BasicAccelDesigner");
+  const AccelDesignerFixed<FixedLimits> adf(1200, 0, 0, 180);
+  const BasicAccelDesigner& bad = adf;
+  EXPECT_FLOAT_EQ(bad.x_end(), 180);
+}
@@ -0,0 +1,166 @@
+/**
+ * @file test_accel_profile.cpp
+ * @brief Unit Test for AccelProfile
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/accel_designer.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace ctrl;
+
+static_assert(sizeof(AccelProfile) * 4 <= sizeof(AccelDesigner),
+              "AccelProfile should be 4x smaller than AccelDesigner");
+static_assert(sizeof(AccelProfile16) * 8 <= sizeof(AccelDesigner),
+              "AccelProfile16 should be 8x smaller than AccelDesigner");
+
+static std::vector<AccelDesigner> makeLibrary(const float j_max,
+                                              const float a_max, const int n) {
+  std::mt19937 mt{std::random_device{}()};
+  std::uniform_real_distribution<float> v_urd(0, 3000);
+  std::uniform_real_distribution<float> x_urd(10, 3000);
+  std::vector<AccelDesigner> ads;
+  for (int i = 0; i < n; ++i) {
+    const float sign = i % 2 ? 1 : -1;
+    ads.emplace_back(j_max, a_max, v_urd(mt) + 100, sign * v_urd(mt),
+                     sign * v_urd(mt), sign * x_urd(mt));
+  }
+  return ads;
+}
+
+TEST(AccelProfile, Restore) {
+  const float j_max = 240000, a_max = 6000;
+  for (const auto& ad : makeLibrary(j_max, a_max, 100)) {
+    AccelDesigner r;
+    r.reset(j_max, a_max, ad.profile(), 10, 0.5f);
+    const AccelDesigner a(j_max, a_max, ad.profile(), 0, 0);
+    /* the same as the original */
+    EXPECT_EQ(a.getTimeStamps(), ad.getTimeStamps());
+    EXPECT_EQ(a.x_end(), ad.x_end());
+    for (float t = 0; t < ad.t_end(); t += 1e-3f) {
+      EXPECT_EQ(a.v(t), ad.v(t));
+      EXPECT_EQ(a.x(t), ad.x(t));
+      EXPECT_NEAR(r.x(t + 0.5f), ad.x(t) + 10, 1e-2f);
+    }
+  }
+}
+
+TEST(AccelProfile, RestoreOffset) {
+  /* bit-identical when |x_start| >= |dist|, up to rounding otherwise */
+  const float j_max = 240000, a_max = 6000;
+  const float x_start = 3456.789f, t_start = 8.9f;
+  const std::vector<std::vector<float>> params = {
+      // vm, vs, vt, d
+      {1200, 0, 300, 540},
+      {1200, 300, 0, 0.1f},
+      {2400, -100, -1200, -2700},
+  };
+  for (const auto& ps : params) {
+    const AccelDesigner ad(j_max, a_max, ps[0], ps[1], ps[2], ps[3], x_start,
+                           t_start);
+    const auto p = ad.profile();
+    EXPECT_EQ(p.dist, ad.x_end() - x_start);
+    EXPECT_NEAR(p.dist, ps[3], 1e-3f);
+    const AccelDesigner r(j_max, a_max, p, x_start, t_start);
+    EXPECT_EQ(r.getTimeStamps(), ad.getTimeStamps());
+    EXPECT_EQ(r.x_end(), ad.x_end());
+    const AccelDesigner o(j_max, a_max, p, 0, t_start);
+    EXPECT_NEAR(o.x_end(), ps[3], 1e-3f);
+    for (float t = t_start; t < ad.t_end(); t += 1e-3f) {
+      EXPECT_EQ(r.v(t), ad.v(t));
+      EXPECT_EQ(r.x(t), ad.x(t));
+      EXPECT_NEAR(o.v(t), ad.v(t), 1e-2f);
+      EXPECT_NEAR(o.x(t) + x_start, ad.x(t), 1e-2f);
+    }
+  }
+}
+
+struct ProfileLimits {
+  static constexpr float j_max = 240000;
+  static constexpr float a_max = 6000;
+};
+
+TEST(AccelProfile, RestoreFixed) {
+  AccelDesignerFixed<ProfileLimits> ad(1200, 0, 300, 540);
+  AccelDesignerFixed<ProfileLimits> r;
+  r.reset(ad.profile());
+  EXPECT_EQ(r.getTimeStamps(), ad.getTimeStamps());
+  EXPECT_EQ(r.x_end(), ad.x_end());
+}
+
+TEST(AccelProfile, Quantized) {
+  const float j_max = 240000, a_max = 6000;
+  const auto ads = makeLibrary(j_max, a_max, 1000);
+  std::vector<AccelProfile> profiles;
+  for (const auto& ad : ads) profiles.push_back(ad.profile());
+  const auto scale = AccelProfileScale::fit(profiles.data(), profiles.size());
+  for (std::size_t i = 0; i < ads.size(); ++i) {
+    const auto& ad = ads[i];
+    const auto& p = profiles[i];
+    /* each curve may stretch by sqrt(v_unit / j_max) on both sides, and the
+     * cruise time dist / v_sat changes with the errors of v_sat and dist */
+    const auto v_sat = std::abs(p.v_sat);
+    const auto t_tol = 4 * std::sqrt(scale.v_unit / j_max) +
+                       std::abs(p.dist) * scale.v_unit / (2 * v_sat * v_sat) +
+                       scale.x_unit / (2 * v_sat) + 1e-4f;
+    const auto q = AccelProfile16::pack(p, scale).unpack(scale);
+    /* half a unit, plus rounding of the unpacked float */
+    const auto tol = [](const float unit, const float x) {
+      return unit / 2 + 1e-6f * std::abs(x);
+    };
+    EXPECT_NEAR(q.v_start, p.v_start, tol(scale.v_unit, p.v_start));
+    EXPECT_NEAR(q.v_sat, p.v_sat, tol(scale.v_unit, p.v_sat));
+    EXPECT_NEAR(q.v_end, p.v_end, tol(scale.v_unit, p.v_end));
+    EXPECT_NEAR(q.dist, p.dist, tol(scale.x_unit, p.dist));
+    const AccelDesigner r(j_max, a_max, q);
+    EXPECT_NEAR(r.x_end(), ad.x_end(), scale.x_unit);
+    EXPECT_NEAR(r.t_end(), ad.t_end(), t_tol);
+    const auto v_abs = std::max({std::abs(p.v_start), std::abs(p.v_sat),
+                                 std::abs(p.v_end)});
+    for (float t = 0; t < ad.t_end(); t += 1e-3f) {
+      EXPECT_NEAR(r.v(t), ad.v(t), a_max * t_tol + scale.v_unit);
+      EXPECT_NEAR(r.x(t), ad.x(t), v_abs * t_tol + scale.x_unit);
+    }
+  }
+}
+
+TEST(AccelProfile, QuantizedNoCruise) {
+  /* v_sat rounded up beyond the reachable velocity leaves no room to cruise */
+  const float j_max = 240000, a_max = 6000;
+  const AccelDesigner ad(j_max, a_max, 1200, 0, 0, 90);
+  const auto p = ad.profile();
+  ASSERT_LT(std::abs(p.v_sat), 1200);
+  const AccelProfileScale scale{p.v_sat / 10.6f, 0.01f};
+  const auto q = AccelProfile16::pack(p, scale).unpack(scale);
+  ASSERT_GT(q.v_sat, p.v_sat);
+  const AccelCurve ac(j_max, a_max, q.v_start, q.v_sat);
+  const AccelCurve dc(j_max, a_max, q.v_sat, q.v_end);
+  ASSERT_GT(ac.x_end() + dc.x_end(), q.dist);
+  /* the cruise time is clamped to zero instead of going negative */
+  const AccelDesigner r(j_max, a_max, q);
+  EXPECT_EQ(r.t_1(), r.t_2());
+  EXPECT_LE(r.t_2(), r.t_3());
+  EXPECT_EQ(r.x_end(), q.dist);
+  /* the position jumps back at t_1 by the quantization error only */
+  const auto jump = ac.x_end() + dc.x_end() - q.dist;
+  float x_prev = r.x(0);
+  for (float t = 0; t < r.t_end(); t += 1e-4f) {
+    const auto x = r.x(t);
+    EXPECT_GE(x - x_prev, -jump - 1e-3f);
+    x_prev = x;
+  }
+}
+
+TEST(AccelProfile, Saturation) {
+  const AccelProfileScale scale{1, 1};
+  const auto q = AccelProfile16::pack({1e6f, -1e6f, 0.4f, -0.6f}, scale);
+  EXPECT_EQ(q.v_start, INT16_MAX);
+  EXPECT_EQ(q.v_sat, INT16_MIN);
+  EXPECT_EQ(q.v_end, 0);
+  EXPECT_EQ(q.dist, -1);
+}
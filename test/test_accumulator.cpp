@@ -0,0 +1,72 @@
+/**
+ * @file test_accumulator.cpp
+ * @brief Unit Test for Accumulator
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/accumulator.h>
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <numeric>
+#include <random>
+
+using namespace ctrl;
+
+template <typename T, std::size_t S>
+static void testAgainstDeque(const int n) {
+  Accumulator<T, S> acc(1);
+  std::deque<T> ref(S, 1);
+  std::mt19937 mt{std::random_device{}()};
+  std::uniform_int_distribution<int> urd(-1000, 1000);
+  for (int i = 0; i < n; ++i) {
+    const T value = static_cast<T>(urd(mt)) / 8;
+    acc.push(value);
+    ref.push_front(value);
+    ref.pop_back();
+    for (std::size_t k = 0; k < S; ++k) ASSERT_EQ(acc[k], ref[k]);
+    const auto sum = std::accumulate(ref.begin(), ref.end(), T());
+    EXPECT_NEAR(acc.average(), sum / static_cast<T>(S), 1e-3);
+    const int m = 1 + i % S;
+    const auto sum_m = std::accumulate(ref.begin(), ref.begin() + m, T());
+    EXPECT_NEAR(acc.average(m), sum_m / static_cast<T>(m), 1e-3);
+  }
+}
+
+TEST(Accumulator, PowerOfTwo) { testAgainstDeque<float, 8>(100); }
+TEST(Accumulator, NonPowerOfTwo) { testAgainstDeque<float, 10>(100); }
+TEST(Accumulator, Integer) { testAgainstDeque<int, 16>(100); }
+
+TEST(Accumulator, NoDrift) {
+  /* running sum of values that are not exact in binary */
+  Accumulator<float, 64> acc;
+  for (int i = 0; i < 100000; ++i) acc.push(0.1f * (i % 7) + 1000);
+  float sum = 0;
+  for (std::size_t k = 0; k < acc.size(); ++k) sum += acc[k];
+  EXPECT_NEAR(acc.sum(), sum, 1e-6f * sum);
+}
+
+TEST(Accumulator, Copy) {
+  Accumulator<float, 4> a(2);
+  a.push(6);
+  const auto b = a;
+  a.clear();
+  EXPECT_FLOAT_EQ(b[0], 6);
+  EXPECT_FLOAT_EQ(b.average(), 3);
+  EXPECT_FLOAT_EQ(a.average(), 0);
+}
+
+TEST(Accumulator, LapSum) {
+  /* after each lap, the sum is that of the lap alone, with no history */
+  Accumulator<float, 10> acc(1e6f);
+  for (int lap = 0; lap < 3; ++lap) {
+    float sum = 0;
+    for (std::size_t k = 0; k < acc.size(); ++k) {
+      const float value = 0.1f * (lap + 1) * k;
+      acc.push(value);
+      sum += value;
+    }
+    EXPECT_EQ(acc.sum(), sum);
+  }
+}
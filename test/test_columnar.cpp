@@ -0,0 +1,112 @@
+/**
+ * @file test_columnar.cpp
+ * @brief Unit Test for ColumnarWriter
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/columnar.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ctrl;
+
+/* parse a file as tools/columnar.py does */
+static void readBack(const std::string& data, ColumnarHeader& header,
+                     std::vector<std::string>& names,
+                     std::vector<std::vector<float>>& columns) {
+  ASSERT_GE(data.size(), sizeof(header));
+  std::memcpy(&header, data.data(), sizeof(header));
+  ASSERT_EQ(std::memcmp(header.magic, "MMCB", 4), 0);
+  ASSERT_EQ(header.version, ColumnarHeader::kVersion);
+  names.clear();
+  for (std::size_t c = 0; c < header.n_columns; ++c)
+    names.emplace_back(
+        data.c_str() + sizeof(header) + c * ColumnarHeader::kNameLength);
+  const auto offset = header.dataOffset();
+  EXPECT_EQ(offset % ColumnarHeader::kAlignment, 0u);
+  ASSERT_EQ(data.size(),
+            offset + header.n_columns * header.n_rows * sizeof(float));
+  /* padding between names and data is zero-filled */
+  for (auto i = sizeof(header) + header.n_columns * ColumnarHeader::kNameLength;
+       i < offset; ++i)
+    EXPECT_EQ(data[i], 0);
+  columns.assign(header.n_columns, std::vector<float>(header.n_rows));
+  for (std::size_t c = 0; c < header.n_columns; ++c)
+    std::memcpy(columns[c].data(),
+                data.data() + offset + c * header.n_rows * sizeof(float),
+                header.n_rows * sizeof(float));
+}
+
+TEST(ColumnarWriter, RoundTrip) {
+  ColumnarWriter bin(ColumnarWriter::kAccelColumns);
+  const std::size_t n = 100;
+  for (std::size_t i = 0; i < n; ++i) {
+    bin << i * 0.5f << -1.0f * i << 2.0f * i;  //< v and x are filled with 0
+    bin.endRow();
+  }
+  EXPECT_EQ(bin.rows(), n);
+  std::stringstream ss;
+  ASSERT_TRUE(bin.write(ss));
+  ColumnarHeader header;
+  std::vector<std::string> names;
+  std::vector<std::vector<float>> columns;
+  readBack(ss.str(), header, names, columns);
+  EXPECT_EQ(header.n_rows, n);
+  ASSERT_EQ(names.size(), 5u);
+  for (std::size_t c = 0; c < names.size(); ++c)
+    EXPECT_EQ(names[c], ColumnarWriter::kAccelColumns[c]);
+  for (std::size_t i = 0; i < n; ++i) {
+    EXPECT_EQ(columns[0][i], i * 0.5f);
+    EXPECT_EQ(columns[1][i], -1.0f * i);
+    EXPECT_EQ(columns[2][i], 2.0f * i);
+    EXPECT_EQ(columns[3][i], 0);
+    EXPECT_EQ(columns[4][i], 0);
+  }
+}
+
+TEST(ColumnarWriter, Spill) {
+  /* rows beyond the in-memory block are read back from the spill file */
+  ColumnarWriter bin({"i", "state.q.x", "a_very_long_column_name"});
+  const std::size_t n = 2 * ColumnarWriter::kBlockRows + 123;
+  for (std::size_t i = 0; i < n; ++i) {
+    bin << float(i) << float(i) + 0.25f << -float(i);
+    bin.endRow();
+  }
+  std::stringstream ss;
+  ASSERT_TRUE(bin.write(ss));
+  ColumnarHeader header;
+  std::vector<std::string> names;
+  std::vector<std::vector<float>> columns;
+  readBack(ss.str(), header, names, columns);
+  ASSERT_EQ(header.n_rows, n);
+  EXPECT_EQ(names[1], "state.q.x");
+  EXPECT_EQ(names[2], std::string("a_very_long_column_name")
+                          .substr(0, ColumnarHeader::kNameLength - 1));
+  for (std::size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(columns[0][i], float(i)) << i;
+    ASSERT_EQ(columns[1][i], float(i) + 0.25f) << i;
+    ASSERT_EQ(columns[2][i], -float(i)) << i;
+  }
+  /* writing twice gives the same result */
+  std::stringstream ss2;
+  ASSERT_TRUE(bin.write(ss2));
+  EXPECT_EQ(ss.str(), ss2.str());
+}
+
+TEST(ColumnarWriter, Empty) {
+  ColumnarWriter bin(ColumnarWriter::kStateColumns);
+  std::stringstream ss;
+  ASSERT_TRUE(bin.write(ss));
+  ColumnarHeader header;
+  std::vector<std::string> names;
+  std::vector<std::vector<float>> columns;
+  readBack(ss.str(), header, names, columns);
+  EXPECT_EQ(header.n_rows, 0u);
+  EXPECT_EQ(header.n_columns, 13u);
+  EXPECT_EQ(ss.str().size(), header.dataOffset());
+}
@@ -0,0 +1,115 @@
+/**
+ * @file test_csv_writer.cpp
+ * @brief Unit Test for CsvWriter
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-08
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/accel_designer.h>
+#include <ctrl/csv_writer.h>
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace ctrl;
+
+TEST(CsvWriter, Rows) {
+  std::stringstream ss;
+  {
+    CsvWriter csv(ss);
+    csv.header({"t", "v", "n"});
+    csv << 0.5f << -1.25 << 3;
+    csv.endRow();
+    csv << 0.125f << 1024.0 << -7;
+    csv.endRow();
+    EXPECT_TRUE(ss.str().empty());  //< not flushed yet
+  }
+  EXPECT_EQ(ss.str(), "t,v,n\n0.5,-1.25,3\n0.125,1024,-7\n");
+}
+
+#if CTRL_CSV_WRITER_TO_CHARS
+TEST(CsvWriter, Shortest) {
+  std::stringstream ss;
+  {
+    CsvWriter csv(ss);
+    csv << 1e-5f << 0.1f << 0.1;
+    csv.endRow();
+  }
+  EXPECT_EQ(ss.str(), "1e-05,0.1,0.1\n");
+}
+#endif
+
+TEST(CsvWriter, Select) {
+  std::stringstream ss;
+  {
+    CsvWriter csv(ss);
+    EXPECT_TRUE(csv.select({1, 2}).good());
+    csv.header({"t", "v", "n"});
+    csv << 0.5f << -1.25 << 3;
+    csv.endRow();
+    csv.selectAll();
+    csv << 1 << 2;
+    csv.endRow();
+  }
+  EXPECT_EQ(ss.str(), "v,n\n-1.25,3\n1,2\n");
+}
+
+TEST(CsvWriter, SelectOutOfRange) {
+  std::stringstream ss;
+  {
+    CsvWriter csv(ss);
+    /* columns beyond kColumnMax are rejected, not shifted out of range */
+    EXPECT_FALSE(csv.select({0, CsvWriter::kColumnMax, 100}).good());
+    csv << 1 << 2;
+    csv.endRow();
+    EXPECT_TRUE(csv.selectAll().good());
+  }
+  EXPECT_EQ(ss.str(), "1\n");
+}
+
+TEST(CsvWriter, SmallBuffer) {
+  std::stringstream ss;
+  {
+    CsvWriter csv(ss, 1);
+    for (int i = 0; i < 1000; ++i) {
+      const float value = i * 0.1f;
+      csv << i << value;
+      csv.endRow();
+    }
+  }
+  /* shortest representation reads back to the same value */
+  float value;
+  int i;
+  char comma;
+  for (int k = 0; k < 1000; ++k) {
+    ss >> i >> comma >> value;
+    EXPECT_EQ(i, k);
+    EXPECT_EQ(value, k * 0.1f);
+  }
+}
+
+TEST(CsvWriter, PrintCurve) {
+  const AccelDesigner ad(100, 10, 4, 0, 2, 4, 1, 0.5f);
+  std::stringstream ss;
+  {
+    CsvWriter csv(ss);
+    printCsv(csv, ad, 1e-2f);
+  }
+  /* the same rows as the member printCsv, read back exactly */
+  int rows = 0;
+  for (float t = ad.t_0(); t < ad.t_end(); t += 1e-2f, ++rows) {
+    float r[5];
+    char comma;
+    ss >> r[0] >> comma >> r[1] >> comma >> r[2] >> comma >> r[3] >> comma >>
+        r[4];
+    ASSERT_TRUE(ss.good());
+    EXPECT_EQ(r[0], t);
+    EXPECT_EQ(r[1], ad.j(t));
+    EXPECT_EQ(r[2], ad.a(t));
+    EXPECT_EQ(r[3], ad.v(t));
+    EXPECT_EQ(r[4], ad.x(t));
+  }
+  EXPECT_GT(rows, 100);
+  ss >> std::ws;
+  EXPECT_TRUE(ss.eof());
+}
@@ -0,0 +1,123 @@
+/**
+ * @file test_library.cpp
+ * @brief Unit Test for LibraryView
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/accel_designer.h>
+#include <ctrl/library.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ctrl;
+
+/* copy into a 4-byte aligned buffer as mmap or a flash section would give */
+static std::vector<uint32_t> toBuffer(const std::string& bytes) {
+  std::vector<uint32_t> buf((bytes.size() + 3) / 4);
+  std::memcpy(buf.data(), bytes.data(), bytes.size());
+  return buf;
+}
+
+TEST(Library, Crc32) {
+  const char data[] = "123456789";
+  EXPECT_EQ(crc32(data, 9), 0xCBF43926u);
+  /* incremental */
+  EXPECT_EQ(crc32(data + 4, 5, crc32(data, 4)), 0xCBF43926u);
+  EXPECT_EQ(crc32(data, 0), 0u);
+}
+
+TEST(Library, Shape) {
+  const std::vector<slalom::Shape> shapes = {
+      slalom::Shape(Pose(45, 45, M_PI / 2), 44),
+      slalom::Shape(Pose(90, 45, M_PI / 4), 30),
+      slalom::Shape(Pose(0, 90, M_PI), 90, 24),
+  };
+  std::stringstream ss;
+  ASSERT_TRUE(writeLibrary(ss, shapes.data(), shapes.size()));
+  const auto bytes = ss.str();
+  EXPECT_EQ(bytes.size(), sizeof(LibraryHeader) + sizeof(slalom::Shape) * 3);
+  const auto buf = toBuffer(bytes);
+  const LibraryView<slalom::Shape> view(buf.data(), bytes.size());
+  ASSERT_TRUE(view.valid());
+  EXPECT_TRUE(view.verify());
+  ASSERT_EQ(view.size(), shapes.size());
+  for (std::size_t i = 0; i < shapes.size(); ++i) {
+    EXPECT_EQ(std::memcmp(&view[i], &shapes[i], sizeof(slalom::Shape)), 0);
+    EXPECT_EQ(view[i].v_ref, shapes[i].v_ref);
+  }
+  std::size_t n = 0;
+  for (const auto& s : view) n += s.total.th > 0;
+  EXPECT_EQ(n, shapes.size());
+}
+
+TEST(Library, AccelProfile16) {
+  std::vector<AccelProfile> profiles;
+  for (int i = 1; i <= 100; ++i)
+    profiles.push_back(
+        AccelDesigner(240000, 6000, 2400, 0, 20 * i, 10 * i).profile());
+  LibraryParams params;
+  params.j_max = 240000;
+  params.a_max = 6000;
+  const auto scale = AccelProfileScale::fit(profiles.data(), profiles.size());
+  params.v_unit = scale.v_unit;
+  params.x_unit = scale.x_unit;
+  std::vector<AccelProfile16> packed;
+  for (const auto& p : profiles)
+    packed.push_back(AccelProfile16::pack(p, scale));
+  std::stringstream ss;
+  ASSERT_TRUE(writeLibrary(ss, packed.data(), packed.size(), params));
+  const auto bytes = ss.str();
+  const auto buf = toBuffer(bytes);
+  const LibraryView<AccelProfile16> view(buf.data(), bytes.size());
+  ASSERT_TRUE(view.verify());
+  ASSERT_EQ(view.size(), packed.size());
+  for (std::size_t i = 0; i < view.size(); ++i) {
+    const AccelDesigner ad(view.params().j_max, view.params().a_max,
+                           view[i].unpack(view.params().scale()));
+    EXPECT_NEAR(ad.x_end(), profiles[i].dist, scale.x_unit);
+  }
+  /* the type must match */
+  EXPECT_FALSE(LibraryView<AccelProfile>(buf.data(), bytes.size()).valid());
+  EXPECT_FALSE(LibraryView<slalom::Shape>(buf.data(), bytes.size()).valid());
+}
+
+TEST(Library, Invalid) {
+  const std::vector<AccelProfile> profiles(10, AccelProfile{0, 1, 0, 1});
+  std::stringstream ss;
+  ASSERT_TRUE(writeLibrary(ss, profiles.data(), profiles.size()));
+  const auto bytes = ss.str();
+  auto buf = toBuffer(bytes);
+  /* truncated */
+  const auto size = bytes.size();
+  EXPECT_FALSE(LibraryView<AccelProfile>(buf.data(), size - 1).valid());
+  EXPECT_FALSE(LibraryView<AccelProfile>(buf.data(), 8).valid());
+  EXPECT_EQ(LibraryView<AccelProfile>(buf.data(), 8).size(), 0u);
+  /* corrupted entry */
+  reinterpret_cast<uint8_t*>(buf.data())[sizeof(LibraryHeader) + 5] ^= 1;
+  const LibraryView<AccelProfile> corrupted(buf.data(), bytes.size());
+  EXPECT_TRUE(corrupted.valid());
+  EXPECT_FALSE(corrupted.verify());
+  /* version */
+  buf = toBuffer(bytes);
+  auto& header = *reinterpret_cast<LibraryHeader*>(buf.data());
+  header.version = LibraryHeader::kVersion + 1;
+  EXPECT_FALSE(LibraryView<AccelProfile>(buf.data(), bytes.size()).valid());
+  /* magic */
+  buf = toBuffer(bytes);
+  reinterpret_cast<char*>(buf.data())[0] = 'X';
+  EXPECT_FALSE(LibraryView<AccelProfile>(buf.data(), bytes.size()).valid());
+  /* empty */
+  std::stringstream es;
+  ASSERT_TRUE(writeLibrary<AccelProfile>(es, nullptr, 0));
+  const auto ebuf = toBuffer(es.str());
+  const LibraryView<AccelProfile> empty(ebuf.data(), es.str().size());
+  EXPECT_TRUE(empty.verify());
+  EXPECT_EQ(empty.size(), 0u);
+  EXPECT_EQ(empty.begin(), empty.end());
+}
@@ -0,0 +1,125 @@
+/**
+ * @file test_path_index.cpp
+ * @brief Unit Test for ctrl::PathIndex
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/path_index.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace ctrl;
+
+TEST(PathIndex, PrefixPoses) {
+  /* each prefix pose matches composing from the start */
+  std::mt19937 mt{std::random_device{}()};
+  std::uniform_real_distribution<float> urd(-1, 1);
+  const Pose start(45, 90, M_PI / 2);
+  PathIndex<64> pi(start);
+  std::vector<Pose> moves;
+  for (int i = 0; i < 64; ++i) {
+    moves.emplace_back(90 * (urd(mt) + 1), 45 * urd(mt), M_PI / 2 * urd(mt));
+    EXPECT_TRUE(pi.push(moves.back(), 100));
+  }
+  ASSERT_EQ(pi.size(), 64u);
+  for (std::size_t k = 0; k <= moves.size(); ++k) {
+    Pose ref = start;
+    for (std::size_t i = 0; i < k; ++i) ref = moves[i].homogeneous(ref);
+    EXPECT_EQ(pi.pose(k).x, ref.x);
+    EXPECT_EQ(pi.pose(k).y, ref.y);
+    EXPECT_EQ(pi.pose(k).th, ref.th);
+    EXPECT_FLOAT_EQ(pi.distance(k), 100.0f * k);
+  }
+}
+
+TEST(PathIndex, StraightAndArc) {
+  /* interpolation is exact for straights and constant-curvature arcs */
+  PathIndex<8> pi;
+  const float r = 45;
+  pi.pushStraight(90);
+  pi.push(Pose(r, r, M_PI / 2), r * M_PI / 2);
+  pi.pushStraight(180);
+  EXPECT_FLOAT_EQ(pi.length(), 90 + r * M_PI / 2 + 180);
+  const auto a = pi.poseAt(45);
+  EXPECT_NEAR(a.x, 45, 1e-4f);
+  EXPECT_NEAR(a.y, 0, 1e-4f);
+  const auto b = pi.poseAt(90 + r * M_PI / 4);
+  EXPECT_NEAR(b.x, 90 + r * std::sin(M_PI / 4), 1e-3f);
+  EXPECT_NEAR(b.y, r - r * std::cos(M_PI / 4), 1e-3f);
+  EXPECT_NEAR(b.th, M_PI / 4, 1e-5f);
+  const auto c = pi.poseAt(pi.length() - 80);
+  EXPECT_NEAR(c.x, 90 + r, 1e-3f);
+  EXPECT_NEAR(c.y, r + 100, 1e-3f);
+  EXPECT_NEAR(c.th, M_PI / 2, 1e-5f);
+  /* out of range is clamped to both ends */
+  EXPECT_EQ(pi.poseAt(-10).x, 0);
+  EXPECT_NEAR(pi.poseAt(1e4f).y, pi.pose(3).y, 1e-4f);
+  EXPECT_EQ(pi.indexAt(0), 0u);
+  EXPECT_EQ(pi.indexAt(91), 1u);
+  EXPECT_EQ(pi.indexAt(1e4f), 2u);
+}
+
+TEST(PathIndex, SlalomContinuity) {
+  /* slalom interpolation is approximate but continuous at move boundaries */
+  const std::vector<slalom::Shape> shapes = {
+      slalom::Shape(Pose(45, 45, M_PI / 2), 44),
+      slalom::Shape(Pose(90, 45, M_PI / 4), 30),
+      slalom::Shape(Pose(0, 90, M_PI), 45, 10),
+  };
+  PathIndex<16> pi(Pose(0, 0, 0.3f));
+  for (const auto& shape : shapes) {
+    pi.pushStraight(90);
+    const auto len = PathIndex<16>::slalomLength(shape);
+    /* the arc length is between the chord and a generous upper bound */
+    EXPECT_GT(len, std::hypot(shape.total.x, shape.total.y));
+    EXPECT_LT(len, shape.total.x + shape.total.y + 2 * 45);
+    EXPECT_TRUE(pi.pushSlalom(shape));
+  }
+  for (std::size_t k = 0; k <= pi.size(); ++k) {
+    const auto s = pi.distance(k);
+    const auto p = pi.poseAt(s);
+    EXPECT_NEAR(p.x, pi.pose(k).x, 1e-3f);
+    EXPECT_NEAR(p.y, pi.pose(k).y, 1e-3f);
+    EXPECT_NEAR(p.th, pi.pose(k).th, 1e-5f);
+  }
+  /* no jumps inside a move */
+  const float ds = 0.5f;
+  Pose prev = pi.poseAt(0);
+  for (float s = ds; s < pi.length(); s += ds) {
+    const auto p = pi.poseAt(s);
+    EXPECT_LT(std::hypot(p.x - prev.x, p.y - prev.y), 2 * ds);
+    prev = p;
+  }
+}
+
+TEST(PathIndex, SlalomLengthStraight) {
+  /* a turn angle left over from rounding is treated as a straight */
+  for (const float th : {0.0f, -0.0f, 1e-9f, -1e-9f}) {
+    slalom::Shape shape(Pose(45, 45, M_PI / 2), 44);
+    shape.total = Pose(90, 0, th);
+    EXPECT_FLOAT_EQ(PathIndex<4>::slalomLength(shape), 90);
+  }
+}
+
+TEST(PathIndex, CapacityAndTruncate) {
+  PathIndex<4> pi;
+  for (int i = 0; i < 4; ++i) EXPECT_TRUE(pi.pushStraight(90));
+  EXPECT_FALSE(pi.pushStraight(90));
+  EXPECT_EQ(pi.size(), 4u);
+  /* replan from the 2nd move */
+  pi.truncate(2);
+  EXPECT_EQ(pi.size(), 2u);
+  EXPECT_FLOAT_EQ(pi.length(), 180);
+  EXPECT_TRUE(pi.push(Pose(45, 45, M_PI / 2), 45 * M_PI / 2));
+  EXPECT_NEAR(pi.pose(3).x, 225, 1e-4f);
+  EXPECT_NEAR(pi.pose(3).y, 45, 1e-4f);
+  pi.truncate(10);
+  EXPECT_EQ(pi.size(), 3u);
+  pi.clear(Pose(1, 2, 3));
+  EXPECT_EQ(pi.size(), 0u);
+  EXPECT_EQ(pi.poseAt(5).x, 1);
+}
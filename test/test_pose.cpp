@@ -0,0 +1,75 @@
+/**
+ * @file test_pose.cpp
+ * @brief Unit Test for Pose
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/pose.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace ctrl;
+
+TEST(Pose, ArcStraight) {
+  const auto q = Pose(1, 2, M_PI / 2).arc(10, 0);
+  EXPECT_NEAR(q.x, 1, 1e-5f);
+  EXPECT_NEAR(q.y, 12, 1e-5f);
+  EXPECT_FLOAT_EQ(q.th, M_PI / 2);
+}
+
+TEST(Pose, ArcCircle) {
+  /* a quarter circle of radius 90 in a single step lands exactly */
+  const float r = 90;
+  const auto q = Pose().arc(r * M_PI / 2, M_PI / 2);
+  EXPECT_NEAR(q.x, r, 1e-4f);
+  EXPECT_NEAR(q.y, r, 1e-4f);
+  EXPECT_FLOAT_EQ(q.th, M_PI / 2);
+  /* pure rotation does not translate */
+  const auto p = Pose(3, 4, 1).arc(0, 2);
+  EXPECT_FLOAT_EQ(p.x, 3);
+  EXPECT_FLOAT_EQ(p.y, 4);
+  EXPECT_FLOAT_EQ(p.th, 3);
+}
+
+TEST(Pose, Sinc) {
+  for (const float x : {0.0f, 1e-4f, 0.015f, -0.0199f, 0.02f, 0.5f, -2.0f})
+    EXPECT_NEAR(Pose::sinc(x), x == 0 ? 1 : std::sin(double(x)) / x, 1e-7f);
+}
+
+TEST(Pose, IntegrateMatchesArc) {
+  std::mt19937 mt{std::random_device{}()};
+  std::uniform_real_distribution<float> ds(0, 2);
+  std::uniform_real_distribution<float> dth(-0.3f, 0.3f);
+  std::vector<Polar> deltas;
+  for (int i = 0; i < 1000; ++i) deltas.emplace_back(ds(mt), dth(mt));
+  std::vector<Pose> trace(deltas.size());
+  const Pose start(10, -5, 0.3f);
+  const auto end =
+      Pose::integrate(start, deltas.data(), deltas.size(), trace.data());
+  Pose q = start;
+  for (std::size_t i = 0; i < deltas.size(); ++i) {
+    q = q.arc(deltas[i].tra, deltas[i].rot);
+    EXPECT_NEAR(trace[i].x, q.x, 1e-2f);
+    EXPECT_NEAR(trace[i].y, q.y, 1e-2f);
+    EXPECT_NEAR(trace[i].th, q.th, 1e-4f);
+  }
+  EXPECT_EQ(end.x, trace.back().x);
+  EXPECT_EQ(end.th, trace.back().th);
+}
+
+TEST(Pose, IntegrateLargeSteps) {
+  /* a quarter circle of radius 90 in 4 steps, compared with Euler steps */
+  const float r = 90;
+  const int n = 4;
+  const std::vector<Polar> deltas(n, Polar(M_PI / 2 * r / n, M_PI / 2 / n));
+  const auto exact = Pose::integrate(Pose(), deltas.data(), n);
+  Pose euler;
+  for (const auto& d : deltas) euler = Pose(d.tra, 0, d.rot).homogeneous(euler);
+  EXPECT_NEAR(exact.x, r, 1e-3f);
+  EXPECT_NEAR(exact.y, r, 1e-3f);
+  EXPECT_GT(std::hypot(euler.x - r, euler.y - r), 10);
+}
@@ -0,0 +1,92 @@
+/**
+ * @file test_replay.cpp
+ * @brief Unit Test for Replayer
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/replay.h>
+#include <ctrl/straight/trajectory.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace ctrl;
+
+/* closed-loop recording with estimates off the reference */
+static std::vector<TelemetryRecord> record(const Replayer::Variant& variant) {
+  const float Ts = TrajectoryTracker::kIntegrationPeriodDefault;
+  TrajectoryTracker tt(variant.tracker_gain);
+  FeedbackController<Polar> fc(variant.model, variant.gain);
+  straight::Trajectory trajectory;
+  trajectory.reset(240000, 6000, 1200, 0, 0, 180);
+  TelemetryRecorder<1024> recorder;
+  tt.reset();
+  fc.reset();
+  State s;
+  for (float t = 0; t < trajectory.t_end(); t += Ts) {
+    trajectory.update(s, t);
+    const auto est_q = s.q + Pose(std::sin(40 * t), 2 * std::sin(30 * t),
+                                  0.02f * std::cos(50 * t));
+    const auto est_v = Polar(0.98f * s.dq.x, 0.1f * std::sin(20 * t));
+    const auto est_a = Polar(s.ddq.x, 0);
+    const auto ref = tt.update(est_q, est_v, est_a, s, Ts);
+    fc.update({ref.v, ref.w}, est_v, {ref.dv, ref.dw}, est_a, Ts);
+    recorder.record(est_q, est_v, est_a, s, ref, fc.getBreakdown());
+  }
+  EXPECT_EQ(recorder.dropped(), 0u);
+  std::vector<TelemetryRecord> records(recorder.available());
+  recorder.read(records.data(), records.size());
+  return records;
+}
+
+static Replayer::Variant makeVariant(const float omega_n, const float Kp) {
+  Replayer::Variant v;
+  v.tracker_gain.omega_n = omega_n;
+  v.model = {Polar(1, 1), Polar(0, 0)};
+  v.gain = {Polar(Kp, Kp), Polar(0.1f, 0.1f), Polar(0, 0)};
+  return v;
+}
+
+TEST(Replayer, ReproducesRecording) {
+  const auto variant = makeVariant(15, 1);
+  const auto records = record(variant);
+  ASSERT_GT(records.size(), 100u);
+  Replayer replayer(variant);
+  std::size_t n = 0;
+  replayer.run(records.data(), records.size(),
+               [&](const TelemetryRecord& r, const Replayer::Output& o) {
+                 ++n;
+                 EXPECT_EQ(o.tracker.v, r.tracker.v) << r.tick;
+                 EXPECT_EQ(o.tracker.w, r.tracker.w) << r.tick;
+                 EXPECT_EQ(o.tracker.dv, r.tracker.dv) << r.tick;
+                 EXPECT_EQ(o.tracker.dw, r.tracker.dw) << r.tick;
+                 EXPECT_EQ(o.bd.u.tra, r.bd.u.tra) << r.tick;
+                 EXPECT_EQ(o.bd.u.rot, r.bd.u.rot) << r.tick;
+                 EXPECT_EQ(o.bd.fbi.tra, r.bd.fbi.tra) << r.tick;
+               });
+  EXPECT_EQ(n, records.size());
+}
+
+TEST(Replayer, VariantChangesOutput) {
+  const auto records = record(makeVariant(15, 1));
+  for (const auto& variant : {makeVariant(5, 1), makeVariant(15, 2)}) {
+    Replayer replayer(variant);
+    float diff_v = 0, diff_u = 0;
+    replayer.run(records.data(), records.size(),
+                 [&](const TelemetryRecord& r, const Replayer::Output& o) {
+                   const auto dv = std::abs(o.tracker.v - r.tracker.v);
+                   const auto du = std::abs(o.bd.u.tra - r.bd.u.tra);
+                   diff_v = std::max(diff_v, dv);
+                   diff_u = std::max(diff_u, du);
+                 });
+    EXPECT_GT(diff_u, 1e-3f);
+    /* the tracker output changes only with the tracker gain */
+    if (variant.tracker_gain.omega_n != 15)
+      EXPECT_GT(diff_v, 1e-3f);
+    else
+      EXPECT_EQ(diff_v, 0);
+  }
+}
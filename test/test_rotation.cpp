@@ -0,0 +1,81 @@
+/**
+ * @file test_rotation.cpp
+ * @brief Unit Test for Rotation and batch Pose transforms
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/pose.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace ctrl;
+
+TEST(Rotation, Compose) {
+  const Rotation a(0.3f), b(-1.1f);
+  const auto ab = b * a;
+  EXPECT_NEAR(ab.angle(), -0.8f, 1e-6f);
+  const auto id = a * a.inverse();
+  EXPECT_NEAR(id.c, 1, 1e-6f);
+  EXPECT_NEAR(id.s, 0, 1e-6f);
+  EXPECT_FLOAT_EQ(Rotation().angle(), 0);
+}
+
+TEST(Rotation, PoseRotate) {
+  /* the cached rotation gives the same result as rotate(angle) */
+  const Pose p(3, -4, 0.5f);
+  const Rotation r(1.2f);
+  const auto a = p.rotate(r), b = p.rotate(1.2f);
+  EXPECT_EQ(a.x, b.x);
+  EXPECT_EQ(a.y, b.y);
+  EXPECT_EQ(a.th, p.th);
+}
+
+TEST(Rotation, BatchPoints) {
+  std::mt19937 mt{std::random_device{}()};
+  std::uniform_real_distribution<float> urd(-100, 100);
+  const Pose offset(45, 90, 2.1f);
+  /* include a tail that does not fill a block */
+  const std::size_t n = 8 * Rotation::kBlock + 5;
+  std::vector<float> x(n), y(n), ox(n), oy(n);
+  for (std::size_t i = 0; i < n; ++i) x[i] = urd(mt), y[i] = urd(mt);
+  Pose::transformPoints(offset, x.data(), y.data(), ox.data(), oy.data(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto q = Pose(x[i], y[i]).homogeneous(offset);
+    EXPECT_FLOAT_EQ(ox[i], q.x);
+    EXPECT_FLOAT_EQ(oy[i], q.y);
+  }
+  /* in place, then back with the inverse: p = R^-1 q - R^-1 t */
+  const auto x0 = x, y0 = y;
+  Pose::transformPoints(offset, x.data(), y.data(), x.data(), y.data(), n);
+  EXPECT_EQ(x, ox);
+  EXPECT_EQ(y, oy);
+  const auto inv = Rotation(offset.th).inverse();
+  const auto t = Pose(offset.x, offset.y).rotate(inv);
+  inv.transform(-t.x, -t.y, x.data(), y.data(), x.data(), y.data(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    EXPECT_NEAR(x[i], x0[i], 1e-4f);
+    EXPECT_NEAR(y[i], y0[i], 1e-4f);
+  }
+}
+
+TEST(Rotation, BatchPoses) {
+  std::mt19937 mt{std::random_device{}()};
+  std::uniform_real_distribution<float> urd(-100, 100);
+  const Pose offset(-10, 20, -0.7f);
+  const std::size_t n = 3 * Rotation::kBlock + 3;
+  std::vector<Pose> in(n), out(n);
+  for (auto& p : in) p = {urd(mt), urd(mt), urd(mt) / 100};
+  Pose::transform(offset, in.data(), out.data(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto q = in[i].homogeneous(offset);
+    EXPECT_FLOAT_EQ(out[i].x, q.x);
+    EXPECT_FLOAT_EQ(out[i].y, q.y);
+    EXPECT_FLOAT_EQ(out[i].th, q.th);
+  }
+  Pose::transform(offset, in.data(), in.data(), n);
+  for (std::size_t i = 0; i < n; ++i) EXPECT_EQ(in[i].x, out[i].x);
+}
@@ -0,0 +1,114 @@
+/**
+ * @file test_sample_range.cpp
+ * @brief Unit Test for SampleRange
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/accel_designer.h>
+#include <ctrl/sample_range.h>
+#include <ctrl/slalom/trajectory.h>
+#include <ctrl/straight/trajectory.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace ctrl;
+
+TEST(SampleRange, AccelDesigner) {
+  const AccelDesigner ad(240, 9, 1.2, 0, 0, 0.72, 0, 0.5);
+  const float Ts = 1e-3f;
+  std::size_t n = 0;
+  float t_last = 0;
+  for (const auto& s : samples(ad, Ts)) {
+    const float t = ad.t_0() + n * Ts;
+    t_last = s.t;
+    EXPECT_FLOAT_EQ(s.t, t);
+    EXPECT_FLOAT_EQ(s.j, ad.j(t));
+    EXPECT_FLOAT_EQ(s.a, ad.a(t));
+    EXPECT_FLOAT_EQ(s.v, ad.v(t));
+    EXPECT_FLOAT_EQ(s.x, ad.x(t));
+    ++n;
+  }
+  /* the last sample is within a period before the end */
+  EXPECT_GT(n, 0u);
+  EXPECT_LE(t_last, ad.t_end());
+  EXPECT_GT(t_last + Ts, ad.t_end());
+}
+
+TEST(SampleRange, NoDrift) {
+  const AccelDesigner ad(240, 9, 1.2, 0, 0, 0.72);
+  const float Ts = 1e-4f;
+  float t_last = 0;
+  for (const auto& s : samples(ad, Ts, 0, 10)) t_last = s.t;
+  EXPECT_FLOAT_EQ(t_last, 10);
+}
+
+TEST(SampleRange, Empty) {
+  const AccelDesigner ad(240, 9, 1.2, 0, 0, 0.72);
+  EXPECT_FALSE(samples(ad, 1e-3f, 1, 0).begin() != samples(ad, 1e-3f).end());
+  EXPECT_FALSE(samples(ad, 0).begin() != samples(ad, 0).end());
+}
+
+TEST(SampleRange, DecimateAndFilter) {
+  const AccelDesigner ad(240, 9, 1.2, 0, 0, 0.72);
+  const float Ts = 1e-3f;
+  std::vector<float> all, decimated, filtered;
+  for (const auto& s : samples(ad, Ts)) all.push_back(s.v);
+  for (const auto& s : samples(ad, Ts).decimate(10)) decimated.push_back(s.v);
+  const auto positive = [](const AccelSample& s) { return s.a > 0; };
+  std::size_t n_positive = 0;
+  for (const auto& s : samples(ad, Ts)) n_positive += positive(s);
+  for (const auto& s : samples(ad, Ts).filter(positive).decimate(2)) {
+    EXPECT_GT(s.a, 0);
+    filtered.push_back(s.v);
+  }
+  ASSERT_EQ(decimated.size(), (all.size() + 9) / 10);
+  for (std::size_t i = 0; i < decimated.size(); ++i)
+    EXPECT_FLOAT_EQ(decimated[i], all[i * 10]);
+  EXPECT_EQ(filtered.size(), (n_positive + 1) / 2);
+}
+
+TEST(SampleRange, StraightTrajectory) {
+  straight::Trajectory tr;
+  tr.reset(240000, 9000, 2400, 0, 0, 1800);
+  const float Ts = 1e-3f;
+  std::size_t n = 0;
+  for (const auto& [t, s] : samples(tr, Ts)) {
+    State r;
+    tr.update(r, t);
+    EXPECT_FLOAT_EQ(s.q.x, r.q.x);
+    EXPECT_FLOAT_EQ(s.dq.x, r.dq.x);
+    ++n;
+  }
+  EXPECT_GT(n, 0u);
+}
+
+TEST(SampleRange, SlalomTrajectory) {
+  const auto shape = slalom::Shape(Pose(45, 45, M_PI / 2), 40);
+  slalom::Trajectory st(shape);
+  st.reset(shape.v_ref);
+  const float Ts = 1e-3f;
+  const auto n = static_cast<std::size_t>(
+      std::round(st.getTimeCurve() / Ts)) + 1;
+  std::vector<State> out(n);
+  st.rollout(Ts, out.data(), n);
+  std::size_t i = 0;
+  for (const auto& [t, s] : samples(st, Ts)) {
+    if (i == 0) {
+      /* the first sample is the origin */
+      EXPECT_FLOAT_EQ(s.q.x, 0);
+      EXPECT_FLOAT_EQ(s.dq.x, shape.v_ref);
+    }
+    /* rollout() uses the same time base */
+    if (i < n) {
+      EXPECT_NEAR(s.q.x, out[i].q.x, 1e-3f * shape.v_ref);
+      EXPECT_NEAR(s.q.y, out[i].q.y, 1e-3f * shape.v_ref);
+      EXPECT_NEAR(s.q.th, out[i].q.th, 1e-4f);
+      EXPECT_NEAR(s.dq.x, out[i].dq.x, 1e-3f * shape.v_ref);
+    }
+    ++i;
+  }
+  EXPECT_EQ(i, n);
+}
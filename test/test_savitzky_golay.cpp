@@ -0,0 +1,86 @@
+/**
+ * @file test_savitzky_golay.cpp
+ * @brief Unit Test for SavitzkyGolay
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/savitzky_golay.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+using namespace ctrl;
+
+/* 5-point linear fit evaluated at the newest sample, computed at compile time */
+static constexpr auto kLinear5 = savitzkyGolayCoefficients<5, 1, 1>();
+static_assert(kLinear5[0] > 0.199f && kLinear5[0] < 0.201f, "");
+static_assert(kLinear5[2] > -1e-6f && kLinear5[2] < 1e-6f, "");
+static_assert(kLinear5[4] > -0.201f && kLinear5[4] < -0.199f, "");
+
+TEST(SavitzkyGolay, Coefficients) {
+  const auto c0 = savitzkyGolayCoefficients<21, 3, 0>();
+  const auto c1 = savitzkyGolayCoefficients<21, 3, 1>();
+  const auto c2 = savitzkyGolayCoefficients<21, 3, 2>();
+  /* polynomials up to degree P are reproduced exactly */
+  for (int k = 0; k <= 3; ++k) {
+    double m0 = 0, m1 = 0, m2 = 0;
+    for (int i = 0; i < 21; ++i) {
+      const auto t = std::pow(-i, k);
+      m0 += c0[i] * t, m1 += c1[i] * t, m2 += c2[i] * t;
+    }
+    /* d^n/dt^n of t^k at t = 0 */
+    EXPECT_NEAR(m0, k == 0 ? 1 : 0, 1e-4) << k;
+    EXPECT_NEAR(m1, k == 1 ? 1 : 0, 1e-4) << k;
+    EXPECT_NEAR(m2, k == 2 ? 2 : 0, 1e-4) << k;
+  }
+}
+
+TEST(SavitzkyGolay, Polynomial) {
+  const float Ts = 1e-3f;
+  SavitzkyGolay<32, 2> sg(Ts);
+  Accumulator<float, 32> acc;
+  /* x(t) = 300 + 800 t - 1500 t^2 */
+  const auto x = [](const float t) { return 300 + 800 * t - 1500 * t * t; };
+  for (int i = 0; i < 100; ++i) {
+    sg.push(x(i * Ts));
+    acc.push(x(i * Ts));
+  }
+  const float t = 99 * Ts;
+  EXPECT_NEAR(sg.value(), x(t), 1e-2f);
+  EXPECT_NEAR(sg.d1(), 800 - 3000 * t, 1e-1f);
+  EXPECT_NEAR(sg.d2(), -3000, 50);
+  EXPECT_FLOAT_EQ(sg.window()[0], x(t));
+  using SG = SavitzkyGolay<32, 2>;
+  EXPECT_NEAR(SG::apply(SG::kCoeff1, acc) / Ts, sg.d1(), 1e-2f);
+}
+
+TEST(SavitzkyGolay, NoiseReduction) {
+  /* a noisy ramp: the filter must beat the backward difference */
+  const float Ts = 1e-3f, slope = 1000;
+  SavitzkyGolay<16, 1> sg(Ts);
+  std::mt19937 mt{std::random_device{}()};
+  std::normal_distribution<float> noise(0, 0.1f);
+  float prev = 0, sg_err = 0, diff_err = 0;
+  for (int i = 0; i < 1000; ++i) {
+    const float v = slope * i * Ts + noise(mt);
+    sg.push(v);
+    if (i >= 16) {
+      sg_err += std::pow(sg.d1() - slope, 2);
+      diff_err += std::pow((v - prev) / Ts - slope, 2);
+    }
+    prev = v;
+  }
+  EXPECT_LT(sg_err, diff_err / 10);
+}
+
+TEST(SavitzkyGolay, Clear) {
+  SavitzkyGolay<8, 2> sg(1e-3f, 5);
+  EXPECT_NEAR(sg.value(), 5, 1e-5f);
+  EXPECT_NEAR(sg.d1(), 0, 1e-2f);
+  sg.push(100);
+  sg.clear(2);
+  EXPECT_NEAR(sg.value(), 2, 1e-5f);
+  EXPECT_NEAR(sg.d2(), 0, 1e-1f);
+}
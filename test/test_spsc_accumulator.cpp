@@ -0,0 +1,73 @@
+/**
+ * @file test_spsc_accumulator.cpp
+ * @brief Unit Test for SpscAccumulator
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/spsc_accumulator.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+using namespace ctrl;
+
+TEST(SpscAccumulator, SingleThread) {
+  SpscAccumulator<float, 5> spsc(1);
+  Accumulator<float, 5> ref(1);
+  EXPECT_FLOAT_EQ(spsc.latest(), 1);
+  for (int i = 0; i < 100; ++i) {
+    const float value = 0.5f * i - 7;
+    spsc.push(value);
+    ref.push(value);
+    const auto snap = spsc.snapshot();
+    for (std::size_t k = 0; k < ref.size(); ++k) EXPECT_EQ(snap[k], ref[k]);
+    EXPECT_FLOAT_EQ(snap.average(), ref.average());
+    EXPECT_EQ(spsc.latest(), value);
+  }
+  EXPECT_EQ(spsc.pushed(), 100u);
+  spsc.clear(3);
+  EXPECT_FLOAT_EQ(spsc.snapshot().average(), 3);
+}
+
+TEST(SpscAccumulator, TrySnapshot) {
+  SpscAccumulator<int, 4, 8> spsc;
+  Accumulator<int, 4> out;
+  EXPECT_TRUE(spsc.trySnapshot(out));
+  for (int i = 1; i <= 3; ++i) spsc.push(i);
+  EXPECT_TRUE(spsc.trySnapshot(out));
+  EXPECT_EQ(out[0], 3);
+  EXPECT_EQ(out[3], 0);
+}
+
+TEST(SpscAccumulator, TwoThreadStress) {
+  /* the producer pushes a counter; every snapshot must be consecutive */
+  const int n = 1 << 20;
+  SpscAccumulator<int, 16, 32> spsc;
+  std::atomic<bool> done{false};
+  std::thread producer([&] {
+    for (int i = 1; i <= n; ++i) spsc.push(i);
+    done.store(true);
+  });
+  int snapshots = 0, retries = 0;
+  Accumulator<int, 16> out;
+  while (!done.load()) {
+    if (!spsc.trySnapshot(out)) {
+      ++retries;
+      continue;
+    }
+    ++snapshots;
+    for (int k = 1; k < static_cast<int>(out.size()); ++k)
+      ASSERT_EQ(out[k], std::max(0, out[0] - k)) << "torn snapshot";
+    const auto latest = spsc.latest();
+    ASSERT_GE(latest, out[0]);
+  }
+  producer.join();
+  const auto last = spsc.snapshot();
+  EXPECT_EQ(last[0], n);
+  EXPECT_EQ(last[15], n - 15);
+  RecordProperty("snapshots", snapshots);
+  RecordProperty("retries", retries);
+}
@@ -0,0 +1,98 @@
+/**
+ * @file test_state_estimator.cpp
+ * @brief Unit Test for StateEstimator
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/state_estimator.h>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <type_traits>
+
+using namespace ctrl;
+
+static_assert(std::is_trivially_copyable<StateEstimator>::value,
+              "StateEstimator must be a plain fixed-size object");
+
+/**
+ * @brief simulate a robot with smooth velocity profiles and noisy sensors
+ * @param[in] pose_period ticks between pose corrections; 0 to disable
+ */
+static void simulate(const int pose_period, float* v_rms, float* a_rms,
+                     float* xy_err) {
+  const float Ts = 1e-3f;
+  const StateEstimator::Noise noise;
+  StateEstimator se(noise);
+  std::mt19937 mt{std::random_device{}()};
+  std::normal_distribution<float> nd(0, 1);
+  const auto v = [](const float t) { return 300 + 200 * std::sin(2 * t); };
+  const auto a = [](const float t) { return 400 * std::cos(2 * t); };
+  const auto w = [](const float t) { return 3 * std::sin(3 * t); };
+  Pose q;
+  double v_sq = 0, a_sq = 0;
+  int n = 0;
+  se.reset(q, {v(0), w(0)}, {a(0), 9});
+  for (int i = 1; i <= 3000; ++i) {
+    const float t = i * Ts;
+    /* ground truth by fine integration */
+    for (int k = 0; k < 10; ++k) {
+      const float tk = t - Ts + (k + 0.5f) * Ts / 10;
+      const float h = Ts / 10;
+      q += Pose(v(tk) * std::cos(q.th) * h, v(tk) * std::sin(q.th) * h,
+                w(tk) * h);
+    }
+    se.predict(Ts);
+    se.updateEncoder(v(t) + noise.encoder * nd(mt));
+    se.updateGyro(w(t) + noise.gyro * nd(mt));
+    if (pose_period && i % pose_period == 0)
+      se.updatePose({q.x + noise.pose_xy * nd(mt),
+                     q.y + noise.pose_xy * nd(mt),
+                     q.th + noise.pose_th * nd(mt)});
+    if (i > 500) {
+      v_sq += std::pow(se.v().tra - v(t), 2);
+      a_sq += std::pow(se.a().tra - a(t), 2);
+      ++n;
+    }
+  }
+  *v_rms = std::sqrt(v_sq / n);
+  *a_rms = std::sqrt(a_sq / n);
+  *xy_err = std::hypot(se.q().x - q.x, se.q().y - q.y);
+}
+
+TEST(StateEstimator, DeadReckoning) {
+  float v_rms, a_rms, xy_err;
+  simulate(0, &v_rms, &a_rms, &xy_err);
+  /* better than a single encoder reading */
+  EXPECT_LT(v_rms, StateEstimator::Noise().encoder);
+  /* a backward difference of the encoder would give 5 / 1e-3 * sqrt(2) */
+  EXPECT_LT(a_rms, 400);
+  EXPECT_LT(xy_err, 20);
+}
+
+TEST(StateEstimator, PoseCorrection) {
+  float v_rms, a_rms, xy_err;
+  simulate(50, &v_rms, &a_rms, &xy_err);
+  EXPECT_LT(xy_err, 5);
+}
+
+TEST(StateEstimator, Covariance) {
+  StateEstimator se;
+  se.reset({}, {}, {}, 1);
+  for (int i = 0; i < 100; ++i) {
+    se.predict(1e-3f);
+    se.updateEncoder(100);
+    se.updateGyro(0.5f);
+    se.update(StateEstimator::Y, 0, 1);
+  }
+  const auto& P = se.covariance();
+  for (std::size_t r = 0; r < StateEstimator::N; ++r) {
+    EXPECT_GT(P[r][r], 0);
+    for (std::size_t c = 0; c < r; ++c)
+      EXPECT_NEAR(P[r][c], P[c][r], 1e-4f * (1 + std::abs(P[r][c])));
+  }
+  EXPECT_NEAR(se.v().tra, 100, 1);
+  EXPECT_NEAR(se.v().rot, 0.5f, 1e-2f);
+}
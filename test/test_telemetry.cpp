@@ -0,0 +1,106 @@
+/**
+ * @file test_telemetry.cpp
+ * @brief Unit Test for TelemetryRecorder
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/telemetry.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+using namespace ctrl;
+
+/* record with every field derived from i, to detect misplaced copies */
+template <std::size_t S>
+static bool recordIndex(TelemetryRecorder<S>& rec, const int i) {
+  const float f = static_cast<float>(i);
+  State ref;
+  ref.q = Pose(f, f + 1, f + 2);
+  ref.dddq = Pose(-f, 0, 0);
+  const TrajectoryTracker::Result tracker{f, 2 * f, 3 * f, 4 * f};
+  FeedbackController<Polar>::Breakdown bd;
+  bd.ff = bd.fb = bd.fbp = bd.fbi = bd.fbd = Polar(0, 0);
+  bd.u = Polar(f, -f);
+  return rec.record(Pose(f, -f, 0.5f * f), Polar(f, 0), Polar(0, f), ref,
+                    tracker, bd);
+}
+
+TEST(TelemetryRecorder, Layout) {
+  EXPECT_EQ(sizeof(TelemetryRecord), 144u);
+  EXPECT_EQ(offsetof(TelemetryRecord, tick), 0u);
+  EXPECT_EQ(offsetof(TelemetryRecord, est_q), 4u);
+  EXPECT_EQ(offsetof(TelemetryRecord, est_v), 16u);
+  EXPECT_EQ(offsetof(TelemetryRecord, est_a), 24u);
+  EXPECT_EQ(offsetof(TelemetryRecord, ref), 32u);
+  EXPECT_EQ(offsetof(TelemetryRecord, tracker), 80u);
+  EXPECT_EQ(offsetof(TelemetryRecord, bd), 96u);
+  /* header bytes as read by tools/telemetry.py */
+  const TelemetryFileHeader header;
+  std::array<unsigned char, sizeof(header)> bytes;
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  EXPECT_EQ(std::memcmp(bytes.data(), "MMTL", 4), 0);
+  EXPECT_EQ(bytes[4] | bytes[5] << 8, kTelemetryVersion);
+  EXPECT_EQ(bytes[6] | bytes[7] << 8, 144);
+}
+
+TEST(TelemetryRecorder, RecordAndRead) {
+  TelemetryRecorder<8> rec;
+  for (int i = 0; i < 5; ++i) EXPECT_TRUE(recordIndex(rec, i));
+  EXPECT_EQ(rec.available(), 5u);
+  std::array<TelemetryRecord, 8> out;
+  ASSERT_EQ(rec.read(out.data(), 3), 3u);
+  for (int i = 0; i < 3; ++i) {
+    const auto& r = out[i];
+    EXPECT_EQ(r.tick, uint32_t(i));
+    EXPECT_EQ(r.est_q.y, -i);
+    EXPECT_EQ(r.est_a.rot, i);
+    EXPECT_EQ(r.ref.q.th, i + 2);
+    EXPECT_EQ(r.ref.dddq.x, -i);
+    EXPECT_EQ(r.tracker.dw, 4 * i);
+    EXPECT_EQ(r.bd.u.rot, -i);
+  }
+  EXPECT_EQ(rec.available(), 2u);
+  EXPECT_EQ(rec.dropped(), 0u);
+}
+
+TEST(TelemetryRecorder, Decimation) {
+  TelemetryRecorder<16> rec(3);
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(recordIndex(rec, i), i % 3 == 0);
+  std::array<TelemetryRecord, 16> out;
+  ASSERT_EQ(rec.read(out.data(), out.size()), 4u);
+  for (int k = 0; k < 4; ++k) {
+    /* tick advances on skipped periods too */
+    EXPECT_EQ(out[k].tick, uint32_t(3 * k));
+    EXPECT_EQ(out[k].est_q.x, 3 * k);
+  }
+  /* 0 is treated as 1 */
+  rec.setDecimation(0);
+  for (int i = 10; i < 13; ++i) EXPECT_TRUE(recordIndex(rec, i));
+}
+
+TEST(TelemetryRecorder, DropAndWraparound) {
+  TelemetryRecorder<4> rec;
+  std::array<TelemetryRecord, 4> out;
+  /* offset the ring by one so that every lap wraps the physical index */
+  int written = 0;
+  recordIndex(rec, written++);
+  ASSERT_EQ(rec.read(out.data(), 4), 1u);
+  for (int lap = 0; lap < 5; ++lap) {
+    const int expected = written;
+    /* fill beyond capacity; the newest records are dropped */
+    for (int i = 0; i < 6; ++i) recordIndex(rec, written++);
+    EXPECT_EQ(rec.dropped(), uint32_t(2 * (lap + 1)));
+    EXPECT_EQ(rec.available(), 4u);
+    /* read in two parts */
+    ASSERT_EQ(rec.read(out.data(), 3), 3u);
+    ASSERT_EQ(rec.read(out.data() + 3, 4), 1u);
+    for (int k = 0; k < 4; ++k)
+      EXPECT_EQ(out[k].tick, uint32_t(expected + k)) << "lap " << lap;
+    EXPECT_EQ(rec.available(), 0u);
+    EXPECT_EQ(rec.read(out.data(), 4), 0u);
+  }
+}
@@ -0,0 +1,119 @@
+/**
+ * @file test_trajectory.cpp
+ * @brief Unit Test for slalom::Trajectory and straight::Trajectory
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/sample_range.h>
+#include <ctrl/slalom/trajectory.h>
+#include <ctrl/straight/trajectory.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace ctrl;
+
+/* e is relative to values larger than 1 */
+static void expectPoseNear(const Pose& a, const Pose& b, const float e) {
+  EXPECT_NEAR(a.x, b.x, e * std::max(1.0f, std::abs(b.x)));
+  EXPECT_NEAR(a.y, b.y, e * std::max(1.0f, std::abs(b.y)));
+  EXPECT_NEAR(a.th, b.th, e * std::max(1.0f, std::abs(b.th)));
+}
+
+static void expectStateNear(const State& a, const State& b, const float e) {
+  expectPoseNear(a.q, b.q, e);
+  expectPoseNear(a.dq, b.dq, e);
+  expectPoseNear(a.ddq, b.ddq, e);
+  expectPoseNear(a.dddq, b.dddq, e);
+}
+
+TEST(SlalomTrajectory, RolloutMatchesUpdate) {
+  const float Ts = 1e-3f;
+  const auto shapes = {
+      slalom::Shape(Pose(45, 45, M_PI / 2), 40),
+      slalom::Shape(Pose(90, 45, M_PI / 4), 30),
+      slalom::Shape(Pose(0, 90, M_PI), 90, 24),
+  };
+  for (const auto& shape : shapes) {
+    for (const bool mirror_x : {false, true}) {
+      for (const float k_slip : {0.0f, 1e-4f}) {
+        slalom::Trajectory st(shape, mirror_x);
+        st.reset(shape.v_ref, 0, 0.1f);
+        const auto n = static_cast<std::size_t>(st.getTimeCurve() / Ts) + 10;
+        std::vector<State> out(n);
+        State s;
+        st.rollout(s, 0.1f, Ts, out.data(), n, k_slip);
+        State r;
+        for (std::size_t i = 0; i < n; ++i) {
+          /* out[i] is at 0.1 + i * Ts; the first one is not integrated */
+          if (i == 0)
+            st.update(r, 0.1f, 0, k_slip);
+          else
+            st.update(r, 0.1f + (i - 1) * Ts, Ts, k_slip);
+          /* jerk is discontinuous; samples near a switching time may differ */
+          expectPoseNear(out[i].q, r.q, 1e-3f);
+          expectPoseNear(out[i].dq, r.dq, 1e-3f);
+          expectPoseNear(out[i].ddq, r.ddq, 1e-3f);
+        }
+        expectStateNear(s, out[n - 1], 0);
+      }
+    }
+  }
+}
+
+TEST(SlalomTrajectory, RolloutFromStart) {
+  const auto shape = slalom::Shape(Pose(45, 45, M_PI / 2), 40);
+  slalom::Trajectory st(shape);
+  st.reset(shape.v_ref);
+  const float Ts = 1e-3f;
+  const auto n =
+      static_cast<std::size_t>(std::round(st.getTimeCurve() / Ts)) + 1;
+  std::vector<State> out(n);
+  st.rollout(Ts, out.data(), n);
+  /* starts at the origin on the reference velocity */
+  EXPECT_EQ(out[0].q.x, 0);
+  EXPECT_EQ(out[0].q.y, 0);
+  EXPECT_FLOAT_EQ(out[0].dq.x, shape.v_ref);
+  /* within a step of the end of the curve */
+  EXPECT_NEAR(out[n - 1].q.x, shape.curve.x, shape.v_ref * Ts);
+  EXPECT_NEAR(out[n - 1].q.y, shape.curve.y, shape.v_ref * Ts);
+  EXPECT_NEAR(out[n - 1].q.th, shape.curve.th, 1e-3f);
+}
+
+TEST(StraightTrajectory, RolloutMatchesUpdate) {
+  straight::Trajectory tr;
+  tr.reset(240000, 9000, 2400, 0, 0, 1800, 0, 0.2f);
+  const float Ts = 1e-3f;
+  const auto n = static_cast<std::size_t>(tr.t_end() / Ts) + 10;
+  std::vector<State> out(n);
+  tr.rollout(Ts, out.data(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    State r;
+    tr.update(r, 0.2f + i * Ts);
+    expectStateNear(out[i], r, 1e-5f);
+  }
+}
+
+struct StraightLimits {
+  static constexpr float j_max = 240000;
+  static constexpr float a_max = 9000;
+};
+
+TEST(StraightTrajectory, FixedLimits) {
+  straight::Trajectory tr;
+  tr.reset(StraightLimits::j_max, StraightLimits::a_max, 2400, 0, 0, 1800);
+  straight::BasicTrajectory<AccelDesignerFixed<StraightLimits>> trf;
+  trf.reset(2400, 0, 0, 1800);
+  EXPECT_NEAR(tr.t_end(), trf.t_end(), 1e-5f);
+  for (const auto& [t, s] : samples(trf, 1e-3f)) {
+    State r;
+    tr.update(r, t);
+    /* jerk is discontinuous at the boundaries */
+    expectPoseNear(s.q, r.q, 1e-4f);
+    expectPoseNear(s.dq, r.dq, 1e-4f);
+    expectPoseNear(s.ddq, r.ddq, 1e-3f);
+  }
+}
@@ -0,0 +1,121 @@
+/**
+ * @file test_window_statistics.cpp
+ * @brief Unit Test for WindowVariance, WindowMinMax and WindowMedian
+ * @author Ryotaro Onuki <kerikun11+github@gmail.com>
+ * @date 2023-07-09
+ * @copyright Copyright 2023 Ryotaro Onuki <kerikun11+github@gmail.com>
+ */
+#include <ctrl/window_statistics.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <vector>
+
+using namespace ctrl;
+
+template <std::size_t S>
+static void testAgainstNaive(const int n, const int range) {
+  const float init = 1;
+  WindowVariance<float, S> wv(init);
+  WindowMinMax<float, S> wm(init);
+  WindowMedian<float, S> wd(init);
+  std::deque<float> ref(S, init);
+  std::mt19937 mt{std::random_device{}()};
+  /* a narrow range produces many duplicates */
+  std::uniform_int_distribution<int> urd(-range, range);
+  for (int i = 0; i < n; ++i) {
+    const float value = static_cast<float>(urd(mt)) / 4;
+    wv.push(value);
+    wm.push(value);
+    wd.push(value);
+    ref.push_front(value);
+    ref.pop_back();
+    /* naive recomputation */
+    double mean = 0, var = 0;
+    for (const auto v : ref) mean += v;
+    mean /= S;
+    for (const auto v : ref) var += (v - mean) * (v - mean);
+    var /= S;
+    std::vector<float> sorted(ref.begin(), ref.end());
+    std::sort(sorted.begin(), sorted.end());
+    const auto median = S % 2 ? sorted[S / 2]
+                              : (sorted[S / 2 - 1] + sorted[S / 2]) / 2;
+    EXPECT_NEAR(wv.mean(), mean, 1e-3);
+    EXPECT_NEAR(wv.variance(), var, 1e-3 * (1 + var));
+    EXPECT_EQ(wm.min(), sorted.front());
+    EXPECT_EQ(wm.max(), sorted.back());
+    EXPECT_EQ(wd.median(), median);
+  }
+}
+
+TEST(WindowStatistics, Small) { testAgainstNaive<2>(200, 1000); }
+TEST(WindowStatistics, Odd) { testAgainstNaive<7>(500, 1000); }
+TEST(WindowStatistics, Even) { testAgainstNaive<16>(500, 1000); }
+TEST(WindowStatistics, Duplicates) { testAgainstNaive<15>(1000, 3); }
+TEST(WindowStatistics, Large) { testAgainstNaive<100>(1000, 1000); }
+
+TEST(WindowStatistics, Monotonic) {
+  /* the worst case for the monotonic deque */
+  WindowMinMax<int, 8> wm;
+  for (int i = 1; i <= 100; ++i) {
+    wm.push(i);
+    EXPECT_EQ(wm.max(), i);
+    EXPECT_EQ(wm.min(), std::max(0, i - 7));
+  }
+  for (int i = 100; i >= 1; --i) wm.push(i);
+  EXPECT_EQ(wm.max(), 8);
+  EXPECT_EQ(wm.min(), 1);
+}
+
+TEST(WindowStatistics, Clear) {
+  WindowVariance<float, 4> wv;
+  WindowMinMax<float, 4> wm;
+  WindowMedian<float, 4> wd;
+  for (const float v : {3.0f, -1.0f, 8.0f}) wv.push(v), wm.push(v), wd.push(v);
+  wv.clear(2), wm.clear(2), wd.clear(2);
+  EXPECT_FLOAT_EQ(wv.mean(), 2);
+  EXPECT_FLOAT_EQ(wv.variance(), 0);
+  EXPECT_FLOAT_EQ(wm.min(), 2);
+  EXPECT_FLOAT_EQ(wm.max(), 2);
+  EXPECT_FLOAT_EQ(wd.median(), 2);
+  wv.push(6), wm.push(6), wd.push(6);
+  EXPECT_FLOAT_EQ(wv.mean(), 3);
+  EXPECT_FLOAT_EQ(wv.variance(), 3);
+  EXPECT_FLOAT_EQ(wm.max(), 6);
+  EXPECT_FLOAT_EQ(wd.median(), 2);
+}
+
+TEST(WindowStatistics, NoDrift) {
+  /* large offset with small, inexact fluctuation */
+  WindowVariance<float, 64> wv(1000);
+  for (int i = 0; i < 100000 + 13; ++i) wv.push(1000 + 0.1f * (i % 7));
+  double mean = 0, var = 0;
+  for (std::size_t k = 0; k < 64; ++k) mean += wv.window()[k];
+  mean /= 64;
+  for (std::size_t k = 0; k < 64; ++k)
+    var += (wv.window()[k] - mean) * (wv.window()[k] - mean);
+  var /= 64;
+  EXPECT_NEAR(wv.mean(), mean, 1e-3);
+  EXPECT_NEAR(wv.variance(), var, 1e-2 * var);
+}
+
+TEST(WindowStatistics, LapReplace) {
+  /* after each lap, the statistics come from that lap alone, so a large
+   * initial offset leaves no trace */
+  WindowVariance<float, 16> wv(1e6f);
+  for (int lap = 0; lap < 3; ++lap) {
+    double mean = 0, var = 0;
+    for (int k = 0; k < 16; ++k) mean += 0.1f * (lap + 1) * k;
+    mean /= 16;
+    for (int k = 0; k < 16; ++k) {
+      const float value = 0.1f * (lap + 1) * k;
+      wv.push(value);
+      var += (value - mean) * (value - mean);
+    }
+    var /= 16;
+    EXPECT_NEAR(wv.mean(), mean, 1e-6);
+    EXPECT_NEAR(wv.variance(), var, 1e-6 * var);
+  }
+}
@@ -0,0 +1,43 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# ============================================================================ #
+"""
+zero-copy loader of columnar binary files written from ctrl::ColumnarWriter
+
+usage:
+    import columnar
+    cols = columnar.load('slalom_0.mmcb')
+    t, x = cols['t'], cols['q.x']  # numpy views of the memory-mapped file
+"""
+import numpy as np
+
+MAGIC = b'MMCB'
+VERSION = 1
+NAME_LENGTH = 16
+ALIGNMENT = 64
+
+# layout of ctrl::ColumnarHeader (include/ctrl/columnar.h)
+HEADER = np.dtype([('magic', 'S4'), ('version', '<u2'),
+                   ('n_columns', '<u2'), ('n_rows', '<u8')])
+
+
+def load(filename):
+    """
+    memory-map a columnar file and return a dict of column name -> float32 view
+    """
+    header = np.fromfile(filename, dtype=HEADER, count=1)
+    if header.size == 0 or header['magic'][0] != MAGIC:
+        raise ValueError(f'{filename}: not a columnar file')
+    if header['version'][0] != VERSION:
+        raise ValueError(f'{filename}: unsupported version')
+    n_columns = int(header['n_columns'][0])
+    n_rows = int(header['n_rows'][0])
+    names = np.fromfile(filename, dtype=f'S{NAME_LENGTH}', count=n_columns,
+                        offset=HEADER.itemsize)
+    end = HEADER.itemsize + NAME_LENGTH * n_columns
+    offset = (end + ALIGNMENT - 1) // ALIGNMENT * ALIGNMENT
+    if n_rows == 0:
+        return {n.decode(): np.empty(0, dtype='<f4') for n in names}
+    data = np.memmap(filename, dtype='<f4', mode='r', offset=offset,
+                     shape=(n_columns, n_rows))
+    return {n.decode(): data[i] for i, n in enumerate(names)}
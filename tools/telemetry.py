@@ -0,0 +1,67 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# ============================================================================ #
+"""
+decoder of telemetry files written from ctrl::TelemetryRecorder
+
+usage:
+    python3 telemetry.py telemetry.bin -o telemetry.csv
+    python3 telemetry.py telemetry.bin -o telemetry.npy
+"""
+import argparse
+import numpy as np
+
+MAGIC = b'MMTL'
+VERSION = 1
+
+# ============================================================================ #
+# layout of ctrl::TelemetryRecord (include/ctrl/telemetry.h)
+_pose = ['x', 'y', 'th']
+_polar = ['tra', 'rot']
+FIELDS = ['tick'] \
+    + [f'est_q.{k}' for k in _pose] \
+    + [f'est_v.{k}' for k in _polar] \
+    + [f'est_a.{k}' for k in _polar] \
+    + [f'ref.{q}.{k}' for q in ['q', 'dq', 'ddq', 'dddq'] for k in _pose] \
+    + [f'tracker.{k}' for k in ['v', 'w', 'dv', 'dw']] \
+    + [f'bd.{b}.{k}' for b in ['ff', 'fb', 'fbp', 'fbi', 'fbd', 'u']
+       for k in _polar]
+DTYPE = np.dtype([(f, '<u4' if f == 'tick' else '<f4') for f in FIELDS])
+HEADER = np.dtype([('magic', 'S4'), ('version', '<u2'),
+                   ('record_size', '<u2')])
+
+
+def load(filename):
+    """
+    load a telemetry file as a structured array (memory-mapped, no copy)
+    """
+    header = np.fromfile(filename, dtype=HEADER, count=1)
+    if header.size == 0 or header['magic'][0] != MAGIC:
+        raise ValueError(f'{filename}: not a telemetry file')
+    if header['version'][0] != VERSION or \
+            header['record_size'][0] != DTYPE.itemsize:
+        raise ValueError(f'{filename}: unsupported version or record size')
+    return np.memmap(filename, dtype=DTYPE, mode='r', offset=HEADER.itemsize)
+
+
+def save_csv(records, filename):
+    """
+    write records as csv with a header line
+    """
+    table = np.column_stack([records[f].astype(np.float64) for f in FIELDS])
+    np.savetxt(filename, table, delimiter=',', header=','.join(FIELDS),
+               comments='', fmt='%.9g')
+
+
+# ============================================================================ #
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('input', help='telemetry file (*.bin)')
+    parser.add_argument('-o', '--output', required=True,
+                        help='output file (*.csv or *.npy)')
+    args = parser.parse_args()
+    records = load(args.input)
+    if args.output.endswith('.npy'):
+        np.save(args.output, records)
+    else:
+        save_csv(records, args.output)